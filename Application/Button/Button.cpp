@@ -5,7 +5,8 @@ bool Button::HandleInterrupt(uint16_t GPIO_Pin) {
 		return false;
 	}
 
-	State newState = (HAL_GPIO_ReadPin(_portPin.Port, _portPin.Pin) == GPIO_PIN_RESET)
+	const GPIO_PinState activeLevel = _isActiveHigh ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	State newState = (HAL_GPIO_ReadPin(_portPin.Port, _portPin.Pin) == activeLevel)
 		? State::Pressed
 		: State::Released;
 
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <functional>
+#include "Delegate.h"
 
 #include "PortPinPair.h"
 
@@ -18,13 +18,17 @@ public:
 		Triggered   // 已触发
 	};
 
+	// 按键回调，在 EXTI 中断或定时器回调中调用，捕获不得超过 Callback::CAPACITY 字节
+	using Callback = Delegate<void()>;
+
 	/**
 	 * @brief 构造函数，初始化按键
 	 * @param portPin 按键的端口和引脚
 	 * @param longPressDuration 长按触发时间（毫秒）
+	 * @param isActiveHigh 按下时引脚是否为高电平（默认低电平有效）
 	 */
-	explicit Button(PortPinPair portPin, uint32_t longPressDuration = 800)
-		: _portPin(portPin), _currentState(State::Released), _pressDuration(0),
+	explicit Button(PortPinPair portPin, uint32_t longPressDuration = 800, bool isActiveHigh = false)
+		: _portPin(portPin), _isActiveHigh(isActiveHigh), _currentState(State::Released), _pressDuration(0),
 		_longPressDuration(longPressDuration), _pressCallback(nullptr),
 		_releaseCallback(nullptr), _shortPressCallback(nullptr),
 		_longPressCallback(nullptr) { }
@@ -46,25 +50,25 @@ public:
 	 * @brief 注册按下回调函数
 	 * @param callback 回调函数
 	 */
-	void RegisterPressCallback(const std::function<void()> &callback) { _pressCallback = callback; }
+	void RegisterPressCallback(const Callback &callback) { _pressCallback = callback; }
 
 	/**
 	 * @brief 注册释放回调函数
 	 * @param callback 回调函数
 	 */
-	void RegisterReleaseCallback(const std::function<void()> &callback) { _releaseCallback = callback; }
+	void RegisterReleaseCallback(const Callback &callback) { _releaseCallback = callback; }
 
 	/**
 	 * @brief 注册短按回调函数
 	 * @param callback 回调函数
 	 */
-	void RegisterShortPressCallback(const std::function<void()> &callback) { _shortPressCallback = callback; }
+	void RegisterShortPressCallback(const Callback &callback) { _shortPressCallback = callback; }
 
 	/**
 	 * @brief 注册长按回调函数
 	 * @param callback 回调函数
 	 */
-	void RegisterLongPressCallback(const std::function<void()> &callback) { _longPressCallback = callback; }
+	void RegisterLongPressCallback(const Callback &callback) { _longPressCallback = callback; }
 
 	/**
 	 * @brief 获取当前按键状态
@@ -74,14 +78,15 @@ public:
 
 private:
 	PortPinPair _portPin;  // 按键的端口和引脚
+	bool _isActiveHigh;    // 按下时引脚是否为高电平
 	State _currentState;   // 当前按键状态
 	uint32_t _pressDuration;  // 按下持续时间
 	uint32_t _longPressDuration;  // 长按触发时间
 
-	std::function<void()> _pressCallback;     // 按下回调函数
-	std::function<void()> _releaseCallback;   // 释放回调函数
-	std::function<void()> _shortPressCallback;  // 短按回调函数
-	std::function<void()> _longPressCallback;   // 长按回调函数
+	Callback _pressCallback;     // 按下回调函数
+	Callback _releaseCallback;   // 释放回调函数
+	Callback _shortPressCallback;  // 短按回调函数
+	Callback _longPressCallback;   // 长按回调函数
 
 	/**
 	 * @brief 更新按键状态并触发回调
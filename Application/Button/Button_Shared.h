@@ -4,5 +4,5 @@
 
 inline PortPinPair fingerprintTouchButtonPair(FingerprintModuleTouchSensor_GPIO_Port, FingerprintModuleTouchSensor_Pin);
 
-// 指纹模块虚拟按钮
-inline Button fingerprintTouchButton(fingerprintTouchButtonPair);
+// 指纹模块虚拟按钮 (模块的触摸输出在手指按下时为高电平)
+inline Button fingerprintTouchButton(fingerprintTouchButtonPair, 800, true);
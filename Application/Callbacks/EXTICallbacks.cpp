@@ -1,8 +1,15 @@
 #include "gpio.h"
 
 #include "Button_Shared.h"
+#include "LatencyTrace_Shared.h"
 
 extern "C" void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+	if (GPIO_Pin == FingerprintModuleTouchSensor_Pin
+		&& HAL_GPIO_ReadPin(FingerprintModuleTouchSensor_GPIO_Port, FingerprintModuleTouchSensor_Pin) == GPIO_PIN_SET) {
+		// 触摸上升沿，开始记录一次开门尝试
+		latencyTrace.BeginAttempt();
+	}
+
 	if (fingerprintTouchButton.HandleInterrupt(GPIO_Pin)) {
 		return;
 	}
@@ -4,6 +4,7 @@
 
 extern bool uart1TxComplete;
 extern bool uart1RxComplete;
+extern uint16_t uart1RxSize;
 extern std::array<uint8_t, 128> uart1TxBuffer;
 extern std::array<uint8_t, 128> uart1RxBuffer;
 
@@ -17,12 +18,17 @@ extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
 // UART DMA 空闲中断回调处理
 extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
 	if (huart->Instance == USART1) {
+		uart1RxSize = Size;
 		uart1RxComplete = true;
 		return;
 	}
 
-	if (huart->Instance == USART2) {
-		// 调用 FPM383C 模块的接收回调处理函数
-		fpm383c.UartRxCallback(Size);
-	}
+	// 查表分发给对应的 FPM383C 驱动 (循环 DMA，Size 为环形缓冲区写入位置)
+	fpm383cRegistry.DispatchRxEvent(huart, Size);
+}
+
+// UART 错误回调处理
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+	// 出错后 HAL 会停止 DMA 接收，由对应的驱动重新启动环形接收
+	fpm383cRegistry.DispatchError(huart);
 }
\ No newline at end of file
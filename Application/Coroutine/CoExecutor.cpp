@@ -0,0 +1,106 @@
+#include "CoExecutor.h"
+
+bool CoExecutor::Init(const ReadyNotifier &notifier) {
+	_notifier = notifier;
+	if (_readyQueue != nullptr) {
+		return true;
+	}
+
+	const osMessageQueueAttr_t attributes = {
+		.name = "CoReadyQueue",
+		.cb_mem = &_readyQueueControlBlock,
+		.cb_size = sizeof(_readyQueueControlBlock),
+		.mq_mem = _readyQueueBuffer.data(),
+		.mq_size = sizeof(_readyQueueBuffer)
+	};
+	_readyQueue = osMessageQueueNew(READY_QUEUE_LENGTH, sizeof(void *), &attributes);
+	return _readyQueue != nullptr;
+}
+
+bool CoExecutor::Spawn(CoTask<void> &&task) {
+	if (!task.IsValid()) {
+		return false;
+	}
+	CoTask<void> owned = std::move(task);
+	std::coroutine_handle<> handle = owned.Detach();
+	if (!Post(handle)) {
+		handle.destroy(); // 无法调度，直接归还协程帧
+		return false;
+	}
+	return true;
+}
+
+bool CoExecutor::Post(std::coroutine_handle<> handle) {
+	if (_readyQueue == nullptr || !handle) {
+		return false;
+	}
+	void *address = handle.address();
+	// 超时为 0，可在 ISR 中调用
+	if (osMessageQueuePut(_readyQueue, &address, 0, 0) != osOK) {
+		return false;
+	}
+	if (_notifier) {
+		_notifier();
+	}
+	return true;
+}
+
+void CoExecutor::Resume(std::coroutine_handle<> handle) {
+	if (!Post(handle) && handle) {
+		handle.resume();
+	}
+}
+
+uint32_t CoExecutor::RunReady() {
+	if (_readyQueue == nullptr) {
+		return osWaitForever;
+	}
+
+	void *address = nullptr;
+	while (osMessageQueueGet(_readyQueue, &address, nullptr, 0) == osOK) {
+		if (address != nullptr) {
+			std::coroutine_handle<>::from_address(address).resume();
+		}
+	}
+	return _resumeExpiredSleepers();
+}
+
+bool CoExecutor::_addSleeper(std::coroutine_handle<> handle, uint32_t ms) {
+	for (auto &sleeper : _sleepers) {
+		if (!sleeper.Handle) {
+			sleeper.Handle = handle;
+			sleeper.WakeTick = osKernelGetTickCount() + ms;
+			return true;
+		}
+	}
+	return false; // 休眠表已满，不挂起 (立即继续执行)
+}
+
+void CoExecutor::_removeSleeper(std::coroutine_handle<> handle) {
+	for (auto &sleeper : _sleepers) {
+		if (sleeper.Handle == handle) {
+			sleeper.Handle = {};
+		}
+	}
+}
+
+/**
+ * @brief 恢复所有已到期的休眠协程
+ * @return 距离下一个休眠协程到期的时间，没有休眠协程时为 osWaitForever；恢复了协程时为 0 (其间可能有新的就绪协程)
+ */
+uint32_t CoExecutor::_resumeExpiredSleepers() {
+	uint32_t timeout = osWaitForever;
+	for (auto &sleeper : _sleepers) {
+		if (!sleeper.Handle) {
+			continue;
+		}
+		const int32_t remaining = static_cast<int32_t>(sleeper.WakeTick - osKernelGetTickCount());
+		if (remaining <= 0) {
+			std::exchange(sleeper.Handle, {}).resume();
+			timeout = 0; // 恢复的协程可能新增了休眠项或就绪项，重新计算
+		} else if (static_cast<uint32_t>(remaining) < timeout) {
+			timeout = static_cast<uint32_t>(remaining);
+		}
+	}
+	return timeout;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+
+#include "cmsis_os.h"
+
+#include "CoTask.h"
+#include "Delegate.h"
+
+/**
+ * @brief 基于 FreeRTOS 的单线程协程执行器
+ * @details - 执行器没有自己的任务，由指纹模块的所有者任务 (FPM383CService::WaitAndProcess()) 调用 RunReady() 驱动，
+ *            所有协程都在该任务中恢复执行，因此协程可以直接访问驱动，彼此之间也无需加锁
+ *          - 就绪队列是静态分配的 CMSIS 消息队列，Post() 可在 ISR 中调用，入队后通过就绪通知唤醒所有者任务
+ *          - Delay() 使用执行器内部的休眠表，不占用软件定时器
+ */
+class CoExecutor {
+public:
+	static constexpr uint32_t READY_QUEUE_LENGTH = 8; // 就绪队列长度
+	static constexpr size_t MAX_SLEEPERS = 4;         // 可同时休眠 (Delay 或带超时等待) 的协程数量
+
+	// 有协程就绪时的通知，必须是 ISR 安全的，用于唤醒调用 RunReady() 的任务
+	using ReadyNotifier = Delegate<void()>;
+
+	/**
+	 * @brief 初始化就绪队列，在驱动执行器的任务中调用
+	 * @param notifier 就绪通知
+	 * @return 是否初始化成功
+	 */
+	bool Init(const ReadyNotifier &notifier);
+
+	/**
+	 * @brief 托管并启动一个顶层协程任务
+	 * @param task 协程任务，完成后协程帧自动归还内存池
+	 * @return false 表示任务无效 (协程帧分配失败) 或就绪队列已满
+	 */
+	bool Spawn(CoTask<void> &&task);
+
+	/**
+	 * @brief 将协程加入就绪队列 (ISR 安全)
+	 * @param handle 要恢复的协程
+	 * @return 是否加入成功
+	 */
+	bool Post(std::coroutine_handle<> handle);
+
+	/**
+	 * @brief 在执行器任务中调度协程恢复，就绪队列已满时直接恢复
+	 * @param handle 要恢复的协程
+	 */
+	void Resume(std::coroutine_handle<> handle);
+
+	/**
+	 * @brief 恢复所有就绪的协程和已到期的休眠协程，不阻塞
+	 * @return 距离下一个休眠协程到期的时间，没有休眠协程时为 osWaitForever
+	 */
+	uint32_t RunReady();
+
+	/**
+	 * @brief 可等待的延时
+	 * @details co_await executor.Delay(100); 挂起当前协程 100ms，期间执行器可运行其他协程
+	 */
+	class DelayAwaiter {
+	public:
+		DelayAwaiter(CoExecutor &executor, uint32_t ms) : _executor(executor), _ms(ms) { }
+		bool await_ready() const noexcept { return _ms == 0; }
+		bool await_suspend(std::coroutine_handle<> handle) { return _executor._addSleeper(handle, _ms); }
+		void await_resume() const noexcept { }
+	private:
+		CoExecutor &_executor;
+		uint32_t _ms;
+	};
+
+	DelayAwaiter Delay(uint32_t ms) { return DelayAwaiter(*this, ms); }
+
+private:
+	friend class CoSignal;
+
+	struct Sleeper {
+		std::coroutine_handle<> Handle;
+		uint32_t WakeTick = 0;
+	};
+
+	bool _addSleeper(std::coroutine_handle<> handle, uint32_t ms);
+	void _removeSleeper(std::coroutine_handle<> handle);
+	uint32_t _resumeExpiredSleepers();
+
+	osMessageQueueId_t _readyQueue = nullptr;
+	StaticQueue_t _readyQueueControlBlock{};
+	std::array<void *, READY_QUEUE_LENGTH> _readyQueueBuffer{};
+	ReadyNotifier _notifier;
+
+	std::array<Sleeper, MAX_SLEEPERS> _sleepers{};
+};
+
+/**
+ * @brief 单个协程的可超时通知
+ * @details - 不锁存: 没有等待者时 Notify() 不产生任何效果，等待的条件由调用方以状态变量表示，醒来后自行检查
+ *          - 只能在执行器任务中使用
+ */
+class CoSignal {
+public:
+	explicit CoSignal(CoExecutor &executor) : _executor(executor) { }
+
+	CoSignal(const CoSignal &) = delete;
+	CoSignal &operator=(const CoSignal &) = delete;
+
+	/**
+	 * @brief 唤醒等待中的协程 (取消其超时)
+	 */
+	void Notify() {
+		if (!_waiter) {
+			return;
+		}
+		_executor._removeSleeper(_waiter);
+		_isNotified = true;
+		_executor.Resume(std::exchange(_waiter, {}));
+	}
+
+	// co_await signal.Wait(ms) 的可等待对象，结果为是否被通知 (false 表示超时)
+	class WaitAwaiter {
+	public:
+		WaitAwaiter(CoSignal &signal, uint32_t timeoutMs) : _signal(signal), _timeoutMs(timeoutMs) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle) {
+			_signal._isNotified = false;
+			if (_timeoutMs != osWaitForever && !_signal._executor._addSleeper(handle, _timeoutMs)) {
+				return false; // 休眠表已满，不挂起 (按超时处理)
+			}
+			_signal._waiter = handle;
+			return true;
+		}
+		bool await_resume() const noexcept {
+			_signal._waiter = {};
+			return _signal._isNotified;
+		}
+	private:
+		CoSignal &_signal;
+		uint32_t _timeoutMs;
+	};
+
+	/**
+	 * @brief 等待通知，一个 CoSignal 同时只能有一个等待者
+	 * @param timeoutMs 超时时间 (毫秒)，osWaitForever 表示不超时
+	 */
+	WaitAwaiter Wait(uint32_t timeoutMs = osWaitForever) { return WaitAwaiter(*this, timeoutMs); }
+
+private:
+	CoExecutor &_executor;
+	std::coroutine_handle<> _waiter;
+	bool _isNotified = false;
+};
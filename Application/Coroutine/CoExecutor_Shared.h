@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CoExecutor.h"
+
+// 全局协程执行器实例，由 fpm383cService 在所有者任务中驱动
+inline CoExecutor coExecutor;
+
+// 驱动使用的协程恢复调度器: 投递到全局执行器的就绪队列
+inline void ScheduleOnCoExecutor(std::coroutine_handle<> handle) {
+	coExecutor.Resume(handle);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "CoroutineArena.h"
+
+/**
+ * @brief 惰性启动的协程任务
+ * @details - 协程帧从 CoroutineArena 分配，分配失败时返回空任务 (IsValid() == false)
+ *          - 可被其他协程 co_await，完成后通过对称转移恢复等待者
+ *          - 顶层任务交给 CoExecutor::Spawn() 运行，完成后自动销毁协程帧
+ * @tparam T 返回值类型
+ */
+template <typename T = void>
+class [[nodiscard]] CoTask;
+
+namespace CoTaskDetail {
+	// 所有 CoTask 共享的 promise 基类: 内存分配、启动/结束策略、等待者
+	struct PromiseBase {
+		std::coroutine_handle<> Continuation; // 等待本任务的协程
+		bool IsDetached = false;              // 是否由执行器托管 (完成后自动销毁)
+
+		static void *operator new(size_t size) noexcept { return CoroutineArena::Allocate(size); }
+		static void operator delete(void *ptr) noexcept { CoroutineArena::Deallocate(ptr); }
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		void unhandled_exception() noexcept { std::terminate(); }
+
+		// 结束时恢复等待者，托管任务则直接销毁自身
+		struct FinalAwaiter {
+			bool await_ready() noexcept { return false; }
+
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+				PromiseBase &promise = handle.promise();
+				if (promise.Continuation) {
+					return promise.Continuation;
+				}
+				if (promise.IsDetached) {
+					handle.destroy();
+				}
+				return std::noop_coroutine();
+			}
+
+			void await_resume() noexcept { }
+		};
+
+		FinalAwaiter final_suspend() noexcept { return {}; }
+	};
+
+	template <typename T>
+	struct Promise : PromiseBase {
+		T Value{};
+		void return_value(T value) { Value = std::move(value); }
+		T TakeValue() { return std::move(Value); }
+	};
+
+	template <>
+	struct Promise<void> : PromiseBase {
+		void return_void() noexcept { }
+		void TakeValue() noexcept { }
+	};
+}
+
+template <typename T>
+class [[nodiscard]] CoTask {
+public:
+	struct promise_type : CoTaskDetail::Promise<T> {
+		CoTask get_return_object() noexcept { return CoTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		static CoTask get_return_object_on_allocation_failure() noexcept { return CoTask(); }
+	};
+
+	CoTask() noexcept = default;
+	CoTask(CoTask &&other) noexcept : _handle(std::exchange(other._handle, {})) { }
+	CoTask &operator=(CoTask &&other) noexcept {
+		if (this != &other) {
+			_destroy();
+			_handle = std::exchange(other._handle, {});
+		}
+		return *this;
+	}
+	CoTask(const CoTask &) = delete;
+	CoTask &operator=(const CoTask &) = delete;
+	~CoTask() { _destroy(); }
+
+	// 协程帧是否分配成功
+	bool IsValid() const noexcept { return static_cast<bool>(_handle); }
+
+	/**
+	 * @brief 放弃所有权，交由执行器托管
+	 * @return 协程句柄，任务完成后协程帧自动销毁
+	 */
+	std::coroutine_handle<> Detach() noexcept {
+		if (_handle) {
+			_handle.promise().IsDetached = true;
+		}
+		return std::exchange(_handle, {});
+	}
+
+	// --- 作为可等待对象: co_await task ---
+	bool await_ready() const noexcept { return !_handle || _handle.done(); }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+		_handle.promise().Continuation = awaiting;
+		return _handle; // 对称转移，立即开始执行本任务
+	}
+
+	T await_resume() {
+		if (!_handle) return T(); // 协程帧分配失败时返回默认值
+		return _handle.promise().TakeValue();
+	}
+
+private:
+	explicit CoTask(std::coroutine_handle<promise_type> handle) noexcept : _handle(handle) { }
+
+	void _destroy() noexcept {
+		if (_handle) {
+			_handle.destroy();
+			_handle = {};
+		}
+	}
+
+	std::coroutine_handle<promise_type> _handle;
+};
@@ -0,0 +1,39 @@
+#include "CoroutineArena.h"
+
+#include <bit>
+
+#include "cmsis_os.h"
+
+void *CoroutineArena::Allocate(size_t size) noexcept {
+	if (size > BLOCK_SIZE) {
+		return nullptr;
+	}
+
+	void *block = nullptr;
+	taskENTER_CRITICAL();
+	const uint32_t freeMask = ~_usedMask & ((1u << BLOCK_COUNT) - 1);
+	if (freeMask != 0) {
+		const int index = std::countr_zero(freeMask);
+		_usedMask |= (1u << index);
+		block = _blocks[index].data();
+	}
+	taskEXIT_CRITICAL();
+	return block;
+}
+
+void CoroutineArena::Deallocate(void *ptr) noexcept {
+	const auto *bytes = static_cast<const uint8_t *>(ptr);
+	const auto *base = _blocks.front().data();
+	if (bytes < base || bytes >= base + BLOCK_SIZE * BLOCK_COUNT) {
+		return; // 不属于本内存池
+	}
+
+	const size_t index = static_cast<size_t>(bytes - base) / BLOCK_SIZE;
+	taskENTER_CRITICAL();
+	_usedMask &= ~(1u << index);
+	taskEXIT_CRITICAL();
+}
+
+uint8_t CoroutineArena::GetUsedBlockCount() noexcept {
+	return static_cast<uint8_t>(std::popcount(_usedMask));
+}
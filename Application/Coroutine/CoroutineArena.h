@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 协程帧的固定块静态内存池
+ * @details 所有 CoTask 的协程帧都从这里分配，不使用堆 (configTOTAL_HEAP_SIZE 只有 3072 字节)
+ *          分配失败时返回 nullptr，CoTask 会据此返回一个空任务，由调用方检查 IsValid()
+ *          仅可在任务上下文中分配和释放
+ */
+class CoroutineArena {
+public:
+	static constexpr size_t BLOCK_SIZE = 256; // 单个协程帧的最大字节数
+	static constexpr size_t BLOCK_COUNT = 4;  // 可同时存在的协程帧数量
+
+	/**
+	 * @brief 分配一个协程帧
+	 * @param size 协程帧大小
+	 * @return 内存块指针，大小超过 BLOCK_SIZE 或没有空闲块时返回 nullptr
+	 */
+	static void *Allocate(size_t size) noexcept;
+
+	/**
+	 * @brief 释放一个协程帧
+	 * @param ptr Allocate 返回的指针
+	 */
+	static void Deallocate(void *ptr) noexcept;
+
+	/**
+	 * @brief 获取当前已使用的内存块数量
+	 */
+	static uint8_t GetUsedBlockCount() noexcept;
+
+private:
+	static_assert(BLOCK_COUNT <= 32, "Block usage is tracked in a 32-bit mask");
+
+	alignas(8) static inline std::array<std::array<uint8_t, BLOCK_SIZE>, BLOCK_COUNT> _blocks{};
+	static inline uint32_t _usedMask = 0; // 第 i 位为 1 表示第 i 块已被使用
+};
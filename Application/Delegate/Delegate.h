@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 2 * sizeof(void *)>
+class Delegate;
+
+/**
+ * @brief 定长、不分配内存的回调委托，用于替代 std::function
+ * @details - 可调用对象直接存放在内部缓冲区中，超出 Capacity 时编译报错，永远不会访问堆
+ *          - 只接受可平凡复制、可平凡析构的可调用对象 (函数指针、按引用或按指针捕获的 lambda)，
+ *            因此复制委托就是复制字节，没有管理函数，可以安全地在 ISR 中调用和在任务中重新注册
+ *          - 调用只有一次间接跳转，没有 std::function 的空检查抛异常路径
+ * @tparam R 返回值类型
+ * @tparam Args 参数类型
+ * @tparam Capacity 内部缓冲区大小 (字节)，默认可容纳一个 this 指针加一个额外捕获
+ */
+template <typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+	static constexpr size_t CAPACITY = Capacity;
+
+	constexpr Delegate() noexcept = default;
+	constexpr Delegate(std::nullptr_t) noexcept { }
+
+	/**
+	 * @brief 由可调用对象构造
+	 * @param callable 函数指针或 lambda，大小不得超过 Capacity
+	 */
+	template <typename F>
+		requires (!std::is_same_v<std::decay_t<F>, Delegate> && !std::is_member_pointer_v<std::decay_t<F>>
+			&& std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+	Delegate(F &&callable) noexcept {
+		using Callable = std::decay_t<F>;
+		static_assert(sizeof(Callable) <= Capacity, "Callable capture is larger than the delegate capacity");
+		static_assert(alignof(Callable) <= alignof(void *), "Callable is over-aligned for the delegate storage");
+		static_assert(std::is_trivially_copyable_v<Callable> && std::is_trivially_destructible_v<Callable>,
+			"Delegate only stores trivially copyable callables; capture by reference or pointer");
+
+		if constexpr (std::is_pointer_v<std::remove_cvref_t<F>>) {
+			if (callable == nullptr) {
+				return;
+			}
+		}
+
+		::new (static_cast<void *>(_storage)) Callable(std::forward<F>(callable));
+		_invoker = [](const void *storage, Args... args) -> R {
+			return (*static_cast<Callable *>(const_cast<void *>(storage)))(std::forward<Args>(args)...);
+		};
+	}
+
+	Delegate(const Delegate &) noexcept = default;
+	Delegate &operator=(const Delegate &) noexcept = default;
+
+	Delegate &operator=(std::nullptr_t) noexcept {
+		_invoker = nullptr;
+		return *this;
+	}
+
+	explicit operator bool() const noexcept { return _invoker != nullptr; }
+
+	/**
+	 * @brief 调用委托，调用前需检查是否为空
+	 */
+	R operator()(Args... args) const {
+		return _invoker(_storage, std::forward<Args>(args)...);
+	}
+
+private:
+	using Invoker = R (*)(const void *, Args...);
+
+	alignas(void *) unsigned char _storage[Capacity]{};
+	Invoker _invoker = nullptr;
+};
@@ -1,5 +1,6 @@
 #include "FPM383C.h"
 #include <algorithm> // for std::copy
+#include <utility>   // for std::exchange
 
 // Only for Debugging
 // #include <cstdio>
@@ -41,19 +42,141 @@ static inline uint32_t platform_get_tick() {
 #endif
 }
 
+/**
+ * @brief 跨平台 CPU 周期计数，用于测量接收中断耗时
+ * @details STM32 使用 DWT 周期计数器 (由 Init() 启用)，ESP32 使用 CCOUNT
+ */
+static inline uint32_t platform_get_cycles() {
+#if defined(USE_HAL_DRIVER)
+	return DWT->CYCCNT;
+#elif defined(ESP_PLATFORM)
+	return esp_cpu_get_cycle_count();
+#endif
+}
+
+/**
+ * @brief 启用 CPU 周期计数器 (STM32 的 DWT 默认关闭)
+ */
+static inline void platform_enable_cycle_counter() {
+#if defined(USE_HAL_DRIVER)
+	CoreDebug->DEMCR = CoreDebug->DEMCR | CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL = DWT->CTRL | DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief 从完整命令帧中取出命令码
+ * @param frame 完整命令帧
+ * @return 命令码，帧长度不足时返回 0
+ */
+static inline uint16_t frame_command(std::span<const uint8_t> frame) {
+	if (frame.size() < FPM383CFrame::FrameSize(0)) {
+		return 0;
+	}
+	return (static_cast<uint16_t>(frame[FPM383CFrame::PREFIX_LEN - 2]) << 8) | frame[FPM383CFrame::PREFIX_LEN - 1];
+}
+
+/**
+ * @brief 从完整命令帧中取出命令负载
+ * @param frame 完整命令帧
+ * @return 命令负载 (不含应用层校验和)
+ */
+static inline std::span<const uint8_t> frame_payload(std::span<const uint8_t> frame) {
+	if (frame.size() < FPM383CFrame::FrameSize(0)) {
+		return {};
+	}
+	return frame.subspan(FPM383CFrame::PREFIX_LEN, frame.size() - FPM383CFrame::FrameSize(0));
+}
+
+/**
+ * @brief 判断命令结果是否说明链路中断 (而不是模块拒绝或调用方中止)
+ */
+static inline bool is_link_failure(FPM383C::Status status) {
+	return status == FPM383C::Status::Timeout || status == FPM383C::Status::InvalidResponse
+		|| status == FPM383C::Status::TransmitError || status == FPM383C::Status::ReceiveError;
+}
+
 /**
  * @brief 初始化指纹模块
+ * @param targetBaudRate 希望切换到的波特率，0 表示不协商
+ * @param knownBaudRate 上次协商成功并保存的波特率，0 表示未知
  * @return 命令执行结果 (状态 + 错误码)
  * @details 执行流程:
- *          1. 打开模块电源
- *          2. 等待 300ms 让模块上电稳定
- *          3. 发送心跳命令验证通信是否正常
+ *          1. 以已知波特率和目标波特率 (若有) 快速探测，都失败时回退到默认波特率再试
+ *          2. 发送设置波特率命令，模块以原波特率应答后切换
+ *          3. 主机重新配置 UART，以心跳验证新波特率
+ *          4. 验证失败时先切回原波特率验证，再以目标波特率验证 (模块已切换但第一次心跳丢失)
  */
-FPM383C::CommandResult FPM383C::Init() {
-	// _setPower(true);
-	// platform_delay(300); // 等待模块上电稳定，必要的初始化时间
+FPM383C::CommandResult FPM383C::Init(uint32_t targetBaudRate/* = 0*/, uint32_t knownBaudRate/* = 0*/) {
+	platform_enable_cycle_counter();
+	if (_powerPin != nullptr) {
+		// 上电并以心跳探测模块就绪，代替固定的上电延时；模块使用非出厂波特率时由下方的探测继续
+		_setPower(true);
+		_awaitPowerUp();
+	}
+
 	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_HEARTBEAT, {}, response, DEFAULT_TIMEOUT_MS);
+	auto heartbeat = [&](uint32_t timeout) {
+		const CommandResult heartbeatResult = _sendCommandAndGetResponse(_fixedFrame<CMD_HEARTBEAT>(), response, timeout);
+		if (heartbeatResult.first == Status::OK) {
+			// 初始化过程中的波特率探测失败不计为链路中断
+			_isLinkDown = false;
+		}
+		return heartbeatResult;
+	};
+
+	// 以指定波特率重新配置 UART 并发送心跳
+	auto probe = [&](uint32_t baudRate, uint32_t timeout) -> CommandResult {
+		if (baudRate != _baudRate && !_setUartBaudRate(baudRate)) {
+			return { Status::ReceiveError, ModuleErrorCode::None };
+		}
+		return heartbeat(timeout);
+	};
+
+	// 上次协商时模块可能已应答并切换，而主机未能确认新波特率，因此目标波特率同样需要探测
+	_targetBaudRate = targetBaudRate;
+	const std::array<uint32_t, 2> savedBaudRates = { knownBaudRate, targetBaudRate != knownBaudRate ? targetBaudRate : 0 };
+	CommandResult result = { Status::UnknownError, ModuleErrorCode::None };
+	for (const uint32_t baudRate : savedBaudRates) {
+		if (result.first != Status::OK && baudRate != 0 && baudRate != DEFAULT_BAUD_RATE) {
+			result = probe(baudRate, BAUD_PROBE_TIMEOUT_MS);
+		}
+	}
+	if (result.first != Status::OK) {
+		// 模块可能已恢复出厂波特率
+		result = probe(DEFAULT_BAUD_RATE, DEFAULT_TIMEOUT_MS);
+	}
+
+	if (result.first != Status::OK || targetBaudRate == 0 || targetBaudRate == _baudRate) {
+		return result;
+	}
+
+	// 协商新波特率
+	const uint32_t previousBaudRate = _baudRate;
+	const std::array<uint8_t, 4> payload = {
+		static_cast<uint8_t>(targetBaudRate >> 24),
+		static_cast<uint8_t>(targetBaudRate >> 16),
+		static_cast<uint8_t>(targetBaudRate >> 8),
+		static_cast<uint8_t>(targetBaudRate & 0xFF)
+	};
+	if (_sendCommandAndGetResponse(_prefixedFrame<CMD_SET_BAUD_RATE>(std::span(payload)), response, DEFAULT_TIMEOUT_MS).first != Status::OK) {
+		// 模块不支持该波特率，保持原波特率
+		return result;
+	}
+
+	platform_delay(BAUD_SWITCH_DELAY_MS);
+	if (_setUartBaudRate(targetBaudRate) && heartbeat(BAUD_PROBE_TIMEOUT_MS).first == Status::OK) {
+		return { Status::OK, ModuleErrorCode::None };
+	}
+
+	// 新波特率验证失败: 模块可能未切换，也可能已切换但验证心跳丢失，两种波特率都要探测
+	for (const uint32_t baudRate : { previousBaudRate, targetBaudRate }) {
+		result = probe(baudRate, DEFAULT_TIMEOUT_MS);
+		if (result.first == Status::OK) {
+			break;
+		}
+	}
+	return result;
 }
 
 /**
@@ -65,12 +188,12 @@ FPM383C::CommandResult FPM383C::Init() {
 FPM383C::CommandResult FPM383C::IsFingerPressed(bool &isPressed) {
 	isPressed = false;
 	std::span<uint8_t> response;
-	CommandResult result = _sendCommandAndGetResponse(CMD_QUERY_FINGER_STATUS, {}, response, DEFAULT_TIMEOUT_MS);
+	CommandResult result = _sendCommandAndGetResponse(_fixedFrame<CMD_QUERY_FINGER_STATUS>(), response, ADAPTIVE_TIMEOUT);
 
 	auto &[status, errCode] = result;
 	if (status == Status::OK) {
-		if (!response.empty()) {
-			isPressed = (response[0] == 1);
+		if (const auto fields = FPM383CResponse::FingerStatusLayout::Decode(response)) {
+			isPressed = (std::get<0>(*fields) == 1);
 		} else {
 			status = Status::InvalidResponse;
 		}
@@ -82,29 +205,53 @@ FPM383C::CommandResult FPM383C::IsFingerPressed(bool &isPressed) {
  * @brief 执行同步 1:N 指纹匹配
  * @param result [out] 匹配结果结构体 (成功标志 + 指纹ID + 匹配分数)
  * @return 命令执行结果
- * @details 响应负载格式 (5字节):
+ * @details 响应负载格式 (6字节，见 FPM383CResponse::MatchLayout):
  *          [0-1]: 匹配结果 (big-endian, uint16, 1=成功, 0=失败)
  *          [2-3]: 匹配分数 (big-endian, uint16)
  *          [4-5]: 指纹 ID (big-endian, uint16)
  *          该函数会阻塞等待用户按下手指并完成匹配
  */
 FPM383C::CommandResult FPM383C::Match(MatchResult &result) {
-	result = { false, 0, 0 };
+	result = {};
 	std::span<uint8_t> response;
-	CommandResult cmdResult = _sendCommandAndGetResponse(CMD_MATCH_SYNC, {}, response, DEFAULT_TIMEOUT_MS);
+	CommandResult cmdResult = _sendCommandAndGetResponse(_fixedFrame<CMD_MATCH_SYNC>(), response, DEFAULT_TIMEOUT_MS);
 
 	auto &[status, errCode] = cmdResult;
+	result.ErrorCode = errCode;
 	if (status == Status::OK) {
-		if (response.size() >= 5) {
-			result.IsSuccess = (response[1] == 1);
-			if (result.IsSuccess) {
-				// 大端序解析匹配分数和指纹 ID
-				result.MatchScore = (static_cast<uint16_t>(response[2]) << 8) | response[3];
-				result.FingerId = (static_cast<uint16_t>(response[4]) << 8) | response[5];
-			}
-		} else if (errCode == ModuleErrorCode::None) {
+		if (!_decodeMatch(response, result)) {
 			result.IsSuccess = false;
-		} else {
+		}
+	}
+	return cmdResult;
+}
+
+FPM383C::CommandResult FPM383C::Verify(uint16_t fingerId, MatchResult &result) {
+	if (_verifySupport == CommandSupport::Unsupported) {
+		// 模块不支持 1:1 比对，以 1:N 匹配代替，已知身份的用户不会因此被拒之门外
+		return Match(result);
+	}
+
+	result = {};
+	const std::array<uint8_t, 2> payload = {
+		static_cast<uint8_t>(fingerId >> 8),
+		static_cast<uint8_t>(fingerId & 0xFF)
+	};
+	std::span<uint8_t> response;
+	CommandResult cmdResult = _sendCommandAndGetResponse(_prefixedFrame<CMD_VERIFY>(std::span(payload)), response, DEFAULT_TIMEOUT_MS);
+
+	auto &[status, errCode] = cmdResult;
+	if (status == Status::ModuleError && errCode == ModuleErrorCode::CmdInvalid) {
+		_verifySupport = CommandSupport::Unsupported;
+		return Match(result);
+	}
+	if (status == Status::OK || status == Status::ModuleError) {
+		_verifySupport = CommandSupport::Supported;
+	}
+
+	result.ErrorCode = errCode;
+	if (status == Status::OK) {
+		if (!_decodeMatch(response, result) || (result.IsSuccess && result.FingerId != fingerId)) {
 			result.IsSuccess = false;
 		}
 	}
@@ -112,12 +259,20 @@ FPM383C::CommandResult FPM383C::Match(MatchResult &result) {
 }
 
 FPM383C::CommandResult FPM383C::AutoEnroll(EnrollStatus &finalStatus, uint16_t fingerId/* = 0xFF*/, uint8_t requiredPresses/* = 6*/,
-	const std::function<void(const EnrollStatus &)> &progressCallback/* = nullptr*/) {
-	return _handleAutoEnrollment(fingerId, requiredPresses, finalStatus, progressCallback);
+	const EnrollCallback &progressCallback/* = nullptr*/) {
+	const CommandResult result = _handleAutoEnrollment(fingerId, requiredPresses, finalStatus, progressCallback);
+	if (result.first != Status::Busy) {
+		_updateShadow(CMD_AUTO_ENROLL, {}, result.first);
+	}
+	return result;
 }
 
-FPM383C::Status FPM383C::StartAsyncMatch() {
-	return _startAsyncOperation(CMD_MATCH_ASYNC, {}, CurrentOperation::AsyncMatch);
+FPM383C::Status FPM383C::StartAsyncMatch(bool preemptEnroll/* = false*/) {
+	return _startMatchOperation(MATCH_ANY_ID, preemptEnroll);
+}
+
+FPM383C::Status FPM383C::StartAsyncVerify(uint16_t fingerId, bool preemptEnroll/* = false*/) {
+	return _startMatchOperation(fingerId, preemptEnroll);
 }
 
 FPM383C::Status FPM383C::StartAsyncEnroll(uint16_t fingerId, uint8_t requiredPresses) {
@@ -130,7 +285,55 @@ FPM383C::Status FPM383C::StartAsyncEnroll(uint16_t fingerId, uint8_t requiredPre
 		static_cast<uint8_t>(_asyncEnrollFingerId >> 8),
 		static_cast<uint8_t>(_asyncEnrollFingerId & 0xFF)
 	};
-	return _startAsyncOperation(CMD_AUTO_ENROLL, payload, CurrentOperation::AsyncEnroll);
+	return _startAsyncOperation(_prefixedFrame<CMD_AUTO_ENROLL>(std::span(payload)), CurrentOperation::AsyncEnroll);
+}
+
+bool FPM383C::AbandonAsyncOperation() {
+	const uint32_t state = _enterCritical();
+	const CurrentOperation cancelled = _currentOperation;
+	const bool isAsync = cancelled == CurrentOperation::AsyncMatch || cancelled == CurrentOperation::AsyncEnroll;
+	if (isAsync) {
+		_currentOperation = CurrentOperation::None;
+		_postAborted(cancelled, ModuleErrorCode::None);
+	}
+	_exitCritical(state);
+
+	if (isAsync) {
+		// 模块可能仍在执行该命令，状态不再可信
+		InvalidateShadow();
+		_markLinkDown();
+	}
+	return isAsync;
+}
+
+/**
+ * @brief 取消进行中的异步匹配或注册，阻塞等待取消应答
+ * @details 由 _startCancel() 发出取消命令，超时时直接释放驱动
+ */
+FPM383C::CommandResult FPM383C::Cancel() {
+	_prepareResponseWait();
+	const Status status = _startCancel(false);
+	if (status != Status::AsyncInProgress) {
+		return { status, ModuleErrorCode::None };
+	}
+	if (!_waitForResponse(CANCEL_TIMEOUT_MS)) {
+		_flushRx();
+	}
+
+	// 超时时在临界区中释放驱动，防止与迟到的应答竞争
+	const uint32_t releaseState = _enterCritical();
+	const bool isTimedOut = _currentOperation == CurrentOperation::Cancelling;
+	if (isTimedOut) {
+		_currentOperation = CurrentOperation::None;
+		_postAborted(_cancelledOperation, ModuleErrorCode::None);
+	}
+	_exitCritical(releaseState);
+	if (isTimedOut && _cancelSupport == CommandSupport::Unknown) {
+		_cancelSupport = CommandSupport::Unsupported;
+	}
+
+	_updateShadow(CMD_CANCEL, {}, _cancelResult.first);
+	return _cancelResult;
 }
 
 FPM383C::CommandResult FPM383C::DeleteFingerprint(uint16_t fingerId) {
@@ -141,27 +344,24 @@ FPM383C::CommandResult FPM383C::DeleteFingerprint(uint16_t fingerId) {
 		0x00, 0x00
 	};
 	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_DELETE_FINGER, payload, response, DEFAULT_TIMEOUT_MS);
+	return _sendCommandAndGetResponse(_prefixedFrame<CMD_DELETE_FINGER>(std::span(payload)), response, DEFAULT_TIMEOUT_MS);
 }
 
 FPM383C::CommandResult FPM383C::DeleteAllFingerprints() {
-	static constexpr std::array<uint8_t, 5> payload = {
-		0x01, // 删除所有指纹
-		0x00, 0x00, 0x00, 0x00
-	};
+	// 负载: 0x01 (删除所有指纹) + 4 字节保留
 	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_DELETE_FINGER, payload, response, DEFAULT_TIMEOUT_MS);
+	return _sendCommandAndGetResponse(_fixedFrame<CMD_DELETE_FINGER, 0x01, 0x00, 0x00, 0x00, 0x00>(), response, DEFAULT_TIMEOUT_MS);
 }
 
 FPM383C::CommandResult FPM383C::GetFingerprintCount(uint16_t &count) {
 	count = 0;
 	std::span<uint8_t> response;
-	CommandResult result = _sendCommandAndGetResponse(CMD_GET_FINGER_COUNT, {}, response, DEFAULT_TIMEOUT_MS);
+	CommandResult result = _sendCommandAndGetResponse(_fixedFrame<CMD_GET_FINGER_COUNT>(), response, ADAPTIVE_TIMEOUT);
 
 	auto &[status, errCode] = result;
 	if (status == Status::OK) {
-		if (response.size() >= 2) {
-			count = (static_cast<uint16_t>(response[0]) << 8) | response[1];
+		if (const auto fields = FPM383CResponse::FingerCountLayout::Decode(response)) {
+			count = std::get<0>(*fields);
 		} else {
 			status = Status::InvalidResponse;
 		}
@@ -169,45 +369,318 @@ FPM383C::CommandResult FPM383C::GetFingerprintCount(uint16_t &count) {
 	return result;
 }
 
-FPM383C::CommandResult FPM383C::SetPassword(uint32_t password, bool writeToFlash/* = true*/) {
-	std::array<uint8_t, 4> payload = {
-		static_cast<uint8_t>(password >> 24),
-		static_cast<uint8_t>(password >> 16),
-		static_cast<uint8_t>(password >> 8),
-		static_cast<uint8_t>(password & 0xFF),
-	};
+FPM383C::CommandResult FPM383C::GetIdBitmap(std::span<uint8_t> bitmap) {
+	std::fill(bitmap.begin(), bitmap.end(), 0);
+	if (_idBitmapSupport == CommandSupport::Unsupported) {
+		return { Status::Unsupported, ModuleErrorCode::None };
+	}
+	if (_currentOperation != CurrentOperation::None) {
+		return { Status::Busy, ModuleErrorCode::None };
+	}
+
+	// 不经过 _sendCommandAndGetResponse()，以免探测超时被判定为链路中断
+	const bool isProbe = _idBitmapSupport == CommandSupport::Unknown;
 	std::span<uint8_t> response;
-	CommandResult result = _sendCommandAndGetResponse(writeToFlash ? CMD_SET_PASSWORD : CMD_SET_PASSWORD_TEMP,
-		payload, response, DEFAULT_TIMEOUT_MS);
+	CommandResult result = { _transmitCommand(_fixedFrame<CMD_GET_ID_BITMAP>()), ModuleErrorCode::None };
+	if (result.first == Status::OK) {
+		result = _awaitResponse(response, isProbe ? ID_BITMAP_PROBE_TIMEOUT_MS : DEFAULT_TIMEOUT_MS);
+	}
+
+	const bool isRejected = result.first == Status::Timeout
+		|| (result.first == Status::ModuleError && result.second == ModuleErrorCode::CmdInvalid);
+	if (isProbe && isRejected) {
+		_idBitmapSupport = CommandSupport::Unsupported;
+		return { Status::Unsupported, result.second };
+	}
+	_updateShadow(CMD_GET_ID_BITMAP, {}, result.first);
+
+	if (result.first == Status::OK) {
+		_idBitmapSupport = CommandSupport::Supported;
+		const size_t length = std::min(response.size(), bitmap.size());
+		std::copy_n(response.begin(), length, bitmap.begin());
+	}
+	return result;
+}
+
+FPM383C::CommandResult FPM383C::SendCommand(uint16_t command, std::span<const uint8_t> payload, ResponseLease &response,
+	uint32_t timeout/* = DEFAULT_TIMEOUT_MS*/) {
+	response.Release();
+	if (_currentOperation != CurrentOperation::None) {
+		return { Status::Busy, ModuleErrorCode::None };
+	}
+	if (FPM383CFrame::FrameSize(payload.size()) > _txBuffer.size()) {
+		return { Status::TransmitError, ModuleErrorCode::None };
+	}
 
+	const std::span<const uint8_t> frame = { _txBuffer.data(), _buildPacket(command, payload) };
+	CommandResult result = { _transmitCommand(frame), ModuleErrorCode::None };
 	if (result.first == Status::OK) {
-		_password = password; // 同步更新当前会话密码
+		result = _awaitResponse(response, timeout);
 	}
+	_updateShadow(command, payload, result.first);
 	return result;
 }
 
+FPM383C::CommandResult FPM383C::SetPassword(uint32_t password, bool writeToFlash/* = true*/) {
+	if constexpr (SUPPORTS_SET_PASSWORD) {
+		const std::array<uint8_t, 4> payload = {
+			static_cast<uint8_t>(password >> 24),
+			static_cast<uint8_t>(password >> 16),
+			static_cast<uint8_t>(password >> 8),
+			static_cast<uint8_t>(password & 0xFF),
+		};
+		std::span<uint8_t> response;
+		CommandResult result = _sendCommandAndGetResponse(writeToFlash
+			? _prefixedFrame<CMD_SET_PASSWORD>(std::span(payload))
+			: _prefixedFrame<CMD_SET_PASSWORD_TEMP>(std::span(payload)),
+			response, DEFAULT_TIMEOUT_MS);
+
+		if (result.first == Status::OK) {
+			_password = password; // 同步更新当前会话密码
+		}
+		return result;
+	} else {
+		return { Status::Unsupported, ModuleErrorCode::None };
+	}
+}
+
 FPM383C::CommandResult FPM383C::UpdateFeatureAfterMatch(uint16_t fingerId) {
 	const std::array<uint8_t, 2> payload = {
 		static_cast<uint8_t>(fingerId >> 8),
 		static_cast<uint8_t>(fingerId & 0xFF),
 	};
 	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_UPDATE_FEATURE, payload, response, DEFAULT_TIMEOUT_MS);
+	return _sendCommandAndGetResponse(_prefixedFrame<CMD_UPDATE_FEATURE>(std::span(payload)), response, DEFAULT_TIMEOUT_MS);
+}
+
+FPM383C::CommandResult FPM383C::RunDeferredFeatureUpdate(uint16_t &fingerId) {
+	fingerId = std::exchange(_deferredFeatureUpdateId, NO_DEFERRED_FEATURE_UPDATE);
+	if (fingerId == NO_DEFERRED_FEATURE_UPDATE) {
+		return { Status::OK, ModuleErrorCode::None };
+	}
+	return UpdateFeatureAfterMatch(fingerId);
+}
+
+FPM383C::Status FPM383C::StartDeferredFeatureUpdate(uint16_t &fingerId) {
+	fingerId = _deferredFeatureUpdateId;
+	if (fingerId == NO_DEFERRED_FEATURE_UPDATE) {
+		return Status::OK;
+	}
+	if (_currentOperation != CurrentOperation::None) {
+		return Status::Busy;
+	}
+	_deferredFeatureUpdateId = NO_DEFERRED_FEATURE_UPDATE;
+	_featureUpdateBatch = { BatchCommand::UpdateFeature(fingerId) };
+	return StartAsyncBatch(_featureUpdateBatch);
+}
+
+/**
+ * @brief 分块上传指纹模板
+ * @details 流水线 (发送缓冲区前半存放请求帧，数据块留在接收槽位中由响应租约固定):
+ *          1. 开始上传，获取模板大小
+ *          2. 请求第 0 块并等待
+ *          3. 持有第 N 块的租约，立即请求第 N+1 块 (在另一个槽位中接收)，然后把第 N 块原地交给 sink
+ *          4. 等待第 N+1 块，释放第 N 块，重复 3
+ *          sink 中止时仍会等待在途请求的响应，保证之后的命令不会收到错位的响应
+ */
+FPM383C::CommandResult FPM383C::UploadTemplate(uint16_t fingerId, const TemplateSink &sink, uint16_t &templateSize) {
+	templateSize = 0;
+	if constexpr (SUPPORTS_TEMPLATE_TRANSFER) {
+		if (_currentOperation != CurrentOperation::None) {
+			return { Status::Busy, ModuleErrorCode::None };
+		}
+		if (!sink) {
+			return { Status::Aborted, ModuleErrorCode::None };
+		}
+
+		const std::array<uint8_t, 2> startPayload = {
+			static_cast<uint8_t>(fingerId >> 8),
+			static_cast<uint8_t>(fingerId & 0xFF)
+		};
+		std::span<uint8_t> response;
+		CommandResult result = _sendCommandAndGetResponse(_prefixedFrame<CMD_UPLOAD_TEMPLATE_START>(std::span(startPayload)), response, DEFAULT_TIMEOUT_MS);
+		if (result.first != Status::OK) {
+			return result;
+		}
+		const auto startFields = FPM383CResponse::UploadTemplateStartLayout::Decode(response);
+		if (!startFields) {
+			_updateShadow(CMD_UPLOAD_TEMPLATE_START, {}, Status::InvalidResponse);
+			return { Status::InvalidResponse, ModuleErrorCode::None };
+		}
+		templateSize = std::get<0>(*startFields);
+
+		const std::span<uint8_t> requestBuffer = _txHalf(0);
+		const uint16_t chunkCount = (templateSize + TEMPLATE_CHUNK_SIZE - 1) / TEMPLATE_CHUNK_SIZE;
+
+		// 请求指定序号的数据块
+		auto requestChunk = [&](uint16_t index) {
+			const std::array<uint8_t, 2> payload = { static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index & 0xFF) };
+			const size_t size = _buildPacket(requestBuffer, CMD_UPLOAD_TEMPLATE_DATA, payload);
+			return _transmitCommand(requestBuffer.first(size));
+		};
+
+		// 等待指定序号的数据块，chunk 持有该块的租约，data 指向租约中的模板数据
+		using ChunkLayout = FPM383CResponse::UploadTemplateDataLayout;
+		auto receiveChunk = [&](uint16_t index, ResponseLease &chunk, std::span<const uint8_t> &data) -> CommandResult {
+			const CommandResult chunkResult = _awaitResponse(chunk, ADAPTIVE_TIMEOUT);
+			if (chunkResult.first != Status::OK) {
+				return chunkResult;
+			}
+			const size_t expected = std::min<size_t>(TEMPLATE_CHUNK_SIZE, templateSize - index * TEMPLATE_CHUNK_SIZE);
+			const auto chunkFields = ChunkLayout::Decode(chunk.Payload());
+			if (!chunkFields || chunk.Payload().size() < ChunkLayout::MIN_SIZE + expected || std::get<0>(*chunkFields) != index) {
+				return { Status::InvalidResponse, ModuleErrorCode::None };
+			}
+			data = chunk.Payload().subspan(ChunkLayout::MIN_SIZE, expected);
+			return { Status::OK, ModuleErrorCode::None };
+		};
+
+		ResponseLease currentChunk;
+		std::span<const uint8_t> currentData;
+		if (chunkCount > 0) {
+			result.first = requestChunk(0);
+			if (result.first == Status::OK) {
+				result = receiveChunk(0, currentChunk, currentData);
+			}
+		}
+
+		for (uint16_t index = 0; index < chunkCount && result.first == Status::OK; index++) {
+			const bool hasNext = index + 1 < chunkCount;
+			if (hasNext) {
+				// 先请求下一块，模块准备和传输期间处理当前块
+				result.first = requestChunk(index + 1);
+				if (result.first != Status::OK) {
+					break;
+				}
+			}
+
+			const bool isAccepted = sink(index * TEMPLATE_CHUNK_SIZE, currentData);
+
+			if (hasNext) {
+				// 在途请求的响应必须取走，即使 sink 已中止
+				ResponseLease nextChunk;
+				std::span<const uint8_t> nextData;
+				const CommandResult nextResult = receiveChunk(index + 1, nextChunk, nextData);
+				if (isAccepted) {
+					result = nextResult;
+				}
+				currentChunk = std::move(nextChunk);
+				currentData = nextData;
+			}
+			if (!isAccepted) {
+				result = { Status::Aborted, ModuleErrorCode::None };
+			}
+		}
+
+		if (result.first != Status::Aborted) {
+			_updateShadow(CMD_UPLOAD_TEMPLATE_DATA, {}, result.first);
+		}
+		return result;
+	} else {
+		return { Status::Unsupported, ModuleErrorCode::None };
+	}
+}
+
+/**
+ * @brief 分块下载指纹模板
+ * @details 流水线 (发送缓冲区两半交替作为数据帧):
+ *          1. 开始下载，告知模块 ID 和模板大小
+ *          2. source 直接把第 0 块写入前半缓冲区的负载位置并补全帧
+ *          3. 发出第 N 块，在发送和等待确认期间由 source 在另一半缓冲区准备第 N+1 块
+ *          4. 等待第 N 块的确认，交换两半缓冲区，重复 3
+ */
+FPM383C::CommandResult FPM383C::DownloadTemplate(uint16_t fingerId, uint16_t templateSize, const TemplateSource &source) {
+	if constexpr (SUPPORTS_TEMPLATE_TRANSFER) {
+		if (_currentOperation != CurrentOperation::None) {
+			return { Status::Busy, ModuleErrorCode::None };
+		}
+		if (!source || templateSize == 0) {
+			return { Status::Aborted, ModuleErrorCode::None };
+		}
+
+		const std::array<uint8_t, 4> startPayload = {
+			static_cast<uint8_t>(fingerId >> 8),
+			static_cast<uint8_t>(fingerId & 0xFF),
+			static_cast<uint8_t>(templateSize >> 8),
+			static_cast<uint8_t>(templateSize & 0xFF)
+		};
+		std::span<uint8_t> response;
+		CommandResult result = _sendCommandAndGetResponse(_prefixedFrame<CMD_DOWNLOAD_TEMPLATE_START>(std::span(startPayload)), response, DEFAULT_TIMEOUT_MS);
+		if (result.first != Status::OK) {
+			return result;
+		}
+
+		const uint16_t chunkCount = (templateSize + TEMPLATE_CHUNK_SIZE - 1) / TEMPLATE_CHUNK_SIZE;
+		std::array<size_t, 2> frameSizes{};
+
+		// 在指定的半区中准备数据帧: 块序号(2) + source 直接写入的数据
+		auto prepareChunk = [&](uint16_t index) {
+			const std::span<uint8_t> buffer = _txHalf(index);
+			const uint16_t offset = index * TEMPLATE_CHUNK_SIZE;
+			const size_t expected = std::min<size_t>(TEMPLATE_CHUNK_SIZE, templateSize - offset);
+			const std::span<uint8_t> payload = buffer.subspan(FPM383CFrame::PREFIX_LEN, 2 + expected);
+			payload[0] = static_cast<uint8_t>(index >> 8);
+			payload[1] = static_cast<uint8_t>(index & 0xFF);
+			if (source(offset, payload.subspan(2)) < expected) {
+				return false;
+			}
+			frameSizes[index & 1] = _sealPacket(buffer, CMD_DOWNLOAD_TEMPLATE_DATA, payload.size());
+			return true;
+		};
+
+		if (!prepareChunk(0)) {
+			return { Status::Aborted, ModuleErrorCode::None };
+		}
+
+		for (uint16_t index = 0; index < chunkCount; index++) {
+			result.first = _transmitCommand(_txHalf(index).first(frameSizes[index & 1]));
+			if (result.first != Status::OK) {
+				break;
+			}
+
+			// 当前块在途期间准备下一块
+			const bool isNextReady = index + 1 >= chunkCount || prepareChunk(index + 1);
+
+			result = _awaitResponse(response, ADAPTIVE_TIMEOUT);
+			if (result.first != Status::OK) {
+				break;
+			}
+			if (!isNextReady) {
+				result = { Status::Aborted, ModuleErrorCode::None };
+				break;
+			}
+		}
+
+		if (result.first != Status::Aborted) {
+			_updateShadow(CMD_DOWNLOAD_TEMPLATE_DATA, {}, result.first);
+		}
+		return result;
+	} else {
+		return { Status::Unsupported, ModuleErrorCode::None };
+	}
 }
 
 std::pair<FPM383C::CommandResult, FPM383C::SystemPolicy> FPM383C::GetSystemPolicy() {
+	if (_shadow.IsPolicyKnown && _currentOperation == CurrentOperation::None) {
+		// 策略只会被 SetSystemPolicy 改变，直接返回上次读取的结果
+		_shadowStats.ElidedCommands++;
+		return { { Status::OK, ModuleErrorCode::None }, _shadow.Policy };
+	}
+
 	SystemPolicy policy;
 	std::span<uint8_t> response;
-	CommandResult result = _sendCommandAndGetResponse(CMD_GET_SYSTEM_POLICY, {}, response, DEFAULT_TIMEOUT_MS);
+	CommandResult result = _sendCommandAndGetResponse(_fixedFrame<CMD_GET_SYSTEM_POLICY>(), response, ADAPTIVE_TIMEOUT);
 
 	auto &[status, errCode] = result;
 	if (status == Status::OK) {
-		if (response.size() >= 4) {
-			// 根据手册 V1.2.0，策略配置位于响应数据的第4个字节 (little-endian)
-			const uint8_t policyByte = response[3];
+		if (const auto fields = FPM383CResponse::SystemPolicyLayout::Decode(response)) {
+			// 根据手册 V1.2.0，策略配置位于 32 位策略字的最低字节 (响应数据的第4个字节)
+			const uint8_t policyByte = static_cast<uint8_t>(std::get<0>(*fields));
 			policy.EnableDuplicateCheck = (policyByte & (1 << 1)) != 0;
 			policy.EnableSelfLearning = (policyByte & (1 << 2)) != 0;
 			policy.Enable360Recognition = (policyByte & (1 << 4)) != 0;
+			_shadow.Policy = policy;
+			_shadow.IsPolicyKnown = true;
 		} else {
 			status = Status::InvalidResponse;
 		}
@@ -229,43 +702,259 @@ std::pair<FPM383C::CommandResult, FPM383C::SystemPolicy> FPM383C::GetSystemPolic
 // 		static_cast<uint8_t>((policyValue >> 24) & 0xFF)
 // 	};
 // 	std::span<uint8_t> response;
-// 	return _sendCommandAndGetResponse(CMD_SET_SYSTEM_POLICY, payload, response, DEFAULT_TIMEOUT_MS);
+// 	return _sendCommandAndGetResponse(_prefixedFrame<CMD_SET_SYSTEM_POLICY>(std::span(payload)), response, DEFAULT_TIMEOUT_MS);
 // }
 
 FPM383C::CommandResult FPM383C::EnterSleepMode(bool isDeepSleep/* = false*/) {
-	const std::array<uint8_t, 1> payload = {
-		isDeepSleep ? static_cast<uint8_t>(0x01) : static_cast<uint8_t>(0x00)
-	};
+	// 负载: 0x00 = 普通休眠, 0x01 = 深度休眠
 	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_ENTER_SLEEP_MODE, payload, response, DEFAULT_TIMEOUT_MS);
+	return _sendCommandAndGetResponse(isDeepSleep
+		? _fixedFrame<CMD_ENTER_SLEEP_MODE, 0x01>()
+		: _fixedFrame<CMD_ENTER_SLEEP_MODE, 0x00>(),
+		response, ADAPTIVE_TIMEOUT);
 }
 
 FPM383C::CommandResult FPM383C::SetLEDControl(const FPM383C::LEDControl::ControlInfo &controlInfo) {
 	// 由于联合体内存布局一致，直接访问 Raw 即可获取所有参数
 	const auto &rawParams = controlInfo.GetRawParams();
 
-	std::array<uint8_t, 5> payload = {
+	std::span<uint8_t> response;
+	if (controlInfo.ControlMode == LEDControl::Mode::Off && controlInfo.LightColor == LEDControl::Color::NoControl
+		&& rawParams == LEDControl::RawParams{ 0, 0, 0 }) {
+		// 最常用的关灯命令直接使用编译期帧
+		return _sendCommandAndGetResponse(_fixedFrame<CMD_SET_LED_CONTROL, 0x00, 0x00, 0x00, 0x00, 0x00>(), response, ADAPTIVE_TIMEOUT);
+	}
+
+	const std::array<uint8_t, 5> payload = {
 		static_cast<uint8_t>(controlInfo.ControlMode),
 		static_cast<uint8_t>(controlInfo.LightColor),
 		rawParams[0],
 		rawParams[1],
 		rawParams[2]
 	};
+	return _sendCommandAndGetResponse(_prefixedFrame<CMD_SET_LED_CONTROL>(std::span(payload)), response, ADAPTIVE_TIMEOUT);
+}
 
-	std::span<uint8_t> response;
-	return _sendCommandAndGetResponse(CMD_SET_LED_CONTROL, payload, response, DEFAULT_TIMEOUT_MS);
+/**
+ * @brief 批量执行多条命令
+ * @details 执行流程:
+ *          1. 发送第一条命令，然后阻塞等待整批完成
+ *          2. 每收到一条响应，在接收回调中记录结果并立即发出下一条命令
+ *          3. 全部完成或 (abortOnFailure 时) 遇到失败后，在接收回调中唤醒调用任务
+ *          超时时间为每条命令各自超时 (自适应或 DEFAULT_TIMEOUT_MS) 之和
+ */
+FPM383C::BatchResult FPM383C::RunBatch(std::span<const BatchCommand> commands, bool abortOnFailure/* = true*/) {
+	if (commands.empty()) {
+		return {};
+	}
+	if (_currentOperation != CurrentOperation::None) {
+		return { { Status::Busy, ModuleErrorCode::None }, 0, 0 };
+	}
+	_prepareResponseWait();
+
+	_batchOwner = BatchOwner::Caller;
+	const Status startStatus = _startBatch(commands, abortOnFailure);
+	if (startStatus == Status::OK) {
+		// 所有命令的效果均已生效，没有产生通信
+		return _batchResult;
+	}
+	if (startStatus != Status::AsyncInProgress) {
+		return { { startStatus, ModuleErrorCode::None }, 0, 0 };
+	}
+
+	if (!_waitForResponse(_batchTimeout(commands))) {
+		// 超时，在临界区中结束批处理，防止接收回调继续发出后续命令
+		const uint32_t state = _enterCritical();
+		const bool isStillRunning = _currentOperation == CurrentOperation::Batch;
+		if (isStillRunning) {
+			_currentOperation = CurrentOperation::None;
+			if (_batchResult.FailedIndex == 0xFF) {
+				_batchResult.Result = { Status::Timeout, ModuleErrorCode::None };
+				_batchResult.FailedIndex = _batchIndex;
+			}
+		}
+		_exitCritical(state);
+		if (isStillRunning) {
+			_flushRx();
+			_markLinkDown();
+		}
+	}
+	return _batchResult;
+}
+
+FPM383C::Status FPM383C::StartAsyncBatch(std::span<const BatchCommand> commands, bool abortOnFailure/* = true*/) {
+	return _startOwnedBatch(commands, abortOnFailure, BatchOwner::Callback, _batchTimeout(commands));
 }
 
 void FPM383C::UartRxCallback(uint16_t size) {
-	_lastRxSize = size;
+	const uint32_t startCycles = platform_get_cycles();
+	_consumeRx(size);
+	const uint32_t cycles = platform_get_cycles() - startCycles;
+	_isrStats.LastRxIsrCycles = cycles;
+	_isrStats.MaxRxIsrCycles = std::max(_isrStats.MaxRxIsrCycles, cycles);
+}
 
-	if (_currentOperation != CurrentOperation::None) {
-		// 异步操作模式: 在中断中直接处理响应，避免阻塞主循环
-		_handleAsyncResponse();
-	} else {
-		// 同步操作模式: 仅设置标志位，由 _sendCommandAndGetResponse() 处理
-		_isResponseReady = true;
+size_t FPM383C::DispatchCompletions() {
+	size_t dispatched = 0;
+	while (_completionHead != _completionTail) {
+		// 先复制再推进读取位置，生产者不会覆盖尚未复制的记录
+		const CompletionRecord record = _completions[_completionHead % COMPLETION_QUEUE_LENGTH];
+		_completionHead = _completionHead + 1;
+
+		const uint32_t startCycles = platform_get_cycles();
+		switch (record.Kind) {
+		case CompletionKind::Match:
+			if (!_resumeWaiter(_matchWaiter, record.Match) && _matchCallback) _matchCallback(record.Match);
+			break;
+		case CompletionKind::EnrollProgress:
+			if (_enrollProgressCallback) _enrollProgressCallback(record.Enroll);
+			break;
+		case CompletionKind::EnrollComplete:
+			if (!_resumeWaiter(_enrollWaiter, record.Enroll) && _enrollCompleteCallback) _enrollCompleteCallback(record.Enroll);
+			break;
+		case CompletionKind::Batch:
+		{
+			const BatchResult result = record.Batch.ToResult();
+			if (!_resumeWaiter(_batchWaiter, result) && _batchCallback) _batchCallback(result);
+			break;
+		}
+		case CompletionKind::RecoveryProbe:
+			if (_currentOperation == CurrentOperation::Recovering) {
+				// 模块返回错误码同样说明链路是通的
+				const Status status = record.Batch.Result;
+				if (status == Status::OK || status == Status::ModuleError) {
+					_completeRecovery(true);
+				} else {
+					_advanceRecovery();
+				}
+			}
+			break;
+		case CompletionKind::RecoveryWait:
+			if (_currentOperation == CurrentOperation::Recovering) {
+				if (_recovery.IsPoweredOff) {
+					_powerOnForRecovery();
+					_startRecoveryProbe();
+				} else {
+					_advanceRecovery();
+				}
+			}
+			break;
+		}
+		_isrStats.MaxDispatchCycles = std::max(_isrStats.MaxDispatchCycles, platform_get_cycles() - startCycles);
+		_isrStats.DispatchedCompletions++;
+		dispatched++;
+	}
+	return dispatched;
+}
+
+void FPM383C::UartErrorCallback() {
+	// HAL 在发生 ORE/FE/NE 等错误后会中止 DMA 接收，重新启动环形接收并丢弃不完整的帧
+	InvalidateShadow();
+	_markLinkDown();
+	_isRxRunning = false;
+	_assembler.Reset();
+	_ensureRxRunning();
+}
+
+// ============================================================================
+// 协程接口
+// ============================================================================
+
+/**
+ * @brief 在 DispatchCompletions() 中把结果交给等待中的协程
+ * @return 是否有协程在等待 (否则交给回调)
+ */
+template<typename T>
+bool FPM383C::_resumeWaiter(CoroutineWaiter<T> &waiter, const T &result) {
+	if (!waiter.Handle) {
+		return false;
+	}
+	*waiter.Result = result;
+	waiter.Result = nullptr;
+	_resumeScheduler(std::exchange(waiter.Handle, {}));
+	return true;
+}
+
+// 各可等待对象先登记等待者再启动操作 (完成记录可能在启动返回前写入)，启动失败时撤销登记并以失败状态继续执行
+
+bool FPM383C::MatchAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	if (_driver._resumeScheduler == nullptr || _driver._matchWaiter.Handle) {
+		_result.OperationStatus = Status::UnknownError;
+		return false;
+	}
+	_driver._matchWaiter = { handle, &_result };
+	const Status status = _driver._startMatchOperation(_fingerId, _preemptEnroll);
+	if (status != Status::AsyncInProgress) {
+		_driver._matchWaiter = {};
+		_result.OperationStatus = status;
+		return false;
+	}
+	return true;
+}
+
+bool FPM383C::EnrollAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	if (_driver._resumeScheduler == nullptr || _driver._enrollWaiter.Handle) {
+		_result.OperationStatus = Status::UnknownError;
+		return false;
+	}
+	_driver._enrollWaiter = { handle, &_result };
+	const Status status = _driver.StartAsyncEnroll(_fingerId, _requiredPresses);
+	if (status != Status::AsyncInProgress) {
+		_driver._enrollWaiter = {};
+		_result.OperationStatus = status;
+		return false;
+	}
+	return true;
+}
+
+bool FPM383C::BatchAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	if (_driver._resumeScheduler == nullptr || _driver._batchWaiter.Handle) {
+		_result.Result = { Status::UnknownError, ModuleErrorCode::None };
+		return false;
 	}
+	const std::span<const BatchCommand> commands = _commands.empty() ? std::span<const BatchCommand>(&_single, 1) : _commands;
+	_driver._batchWaiter = { handle, &_result };
+	const Status status = _driver.StartAsyncBatch(commands, _abortOnFailure);
+	if (status != Status::AsyncInProgress) {
+		_driver._batchWaiter = {};
+		_result.Result = { status, ModuleErrorCode::None };
+		return false;
+	}
+	return true;
+}
+
+bool FPM383C::FeatureUpdateAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	if (_driver._deferredFeatureUpdateId == NO_DEFERRED_FEATURE_UPDATE) {
+		_result.Result = { Status::OK, ModuleErrorCode::None };
+		return false;
+	}
+	if (_driver._resumeScheduler == nullptr || _driver._batchWaiter.Handle) {
+		_result.Result = { Status::UnknownError, ModuleErrorCode::None };
+		return false;
+	}
+	_driver._batchWaiter = { handle, &_result };
+	const Status status = _driver.StartDeferredFeatureUpdate(_fingerId);
+	if (status != Status::AsyncInProgress) {
+		_driver._batchWaiter = {};
+		_result.Result = { status, ModuleErrorCode::None };
+		return false;
+	}
+	return true;
+}
+
+bool FPM383C::RecoveryAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	if (_driver._resumeScheduler == nullptr || _driver._recoveryWaiter.Handle) {
+		_status = Status::UnknownError;
+		return false;
+	}
+	_driver._recoveryWaiter = { handle, &_level };
+	_status = _driver.StartRecovery();
+	if (_status != Status::AsyncInProgress) {
+		_driver._recoveryWaiter = {};
+		return false;
+	}
+	// 恢复可能已同步结束，此时协程已交给恢复调度器，之后不得再访问本对象
+	return true;
 }
 
 // ============================================================================
@@ -274,290 +963,1359 @@ void FPM383C::UartRxCallback(uint16_t size) {
 
 /**
  * @brief 发送命令并等待响应 (同步阻塞模式)
- * @param command 命令码
- * @param payload 命令负载数据
+ * @param frame 完整命令帧 (位于发送缓冲区或 Flash 中)
  * @param responsePayload [out] 返回的响应负载 (引用，指向内部缓冲区)
  * @param timeout 超时时间 (毫秒)
  * @return 命令执行结果
  * @details 执行流程:
  *          1. 检查是否有异步操作正在进行
- *          2. 启动 UART DMA 接收
- *          3. 构造并发送命令包
- *          4. 阻塞等待响应或超时
+ *          2. 确保环形 DMA 接收已启动，丢弃残留数据
+ *          3. 发送命令帧
+ *          4. 阻塞等待响应或超时 (由 UartRxCallback 直接唤醒，不轮询)
  *          5. 解析响应包并返回结果
- *          注意: 该函数会占用 CPU 进行轮询等待
  */
-FPM383C::CommandResult FPM383C::_sendCommandAndGetResponse(uint16_t command, std::span<const uint8_t> payload,
-	std::span<uint8_t> &responsePayload, uint32_t timeout) {
-	// 检查是否有异步操作正在进行
-	if (_currentOperation != CurrentOperation::None) {
-		return { Status::Busy, ModuleErrorCode::None };
+FPM383C::CommandResult FPM383C::_sendCommandAndGetResponse(std::span<const uint8_t> frame,
+	std::span<uint8_t> &responsePayload, uint32_t timeout) {
+	// 检查是否有异步操作正在进行
+	if (_currentOperation != CurrentOperation::None) {
+		return { Status::Busy, ModuleErrorCode::None };
+	}
+
+	// 效果已生效的命令直接省略
+	const uint16_t command = frame_command(frame);
+	const std::span<const uint8_t> payload = frame_payload(frame);
+	if (_isRedundant(command, payload)) {
+		_shadowStats.ElidedCommands++;
+		responsePayload = {};
+		return { Status::OK, ModuleErrorCode::None };
+	}
+
+	CommandResult result = { _transmitCommand(frame), ModuleErrorCode::None };
+	if (result.first == Status::OK) {
+		result = _awaitResponse(responsePayload, timeout);
+	}
+
+	_updateShadow(command, payload, result.first);
+	return result;
+}
+
+/**
+ * @brief 发出命令帧，不等待响应
+ * @param frame 完整命令帧
+ * @return OK 表示已开始发送，之后用 _awaitResponse() 等待响应
+ * @details 丢弃之前残留的接收数据并准备等待，发送期间调用方可以继续准备下一帧
+ */
+FPM383C::Status FPM383C::_transmitCommand(std::span<const uint8_t> frame) {
+	// 确保环形接收已启动，并丢弃之前残留的数据
+	if (!_ensureRxRunning()) {
+		return Status::ReceiveError;
+	}
+	_flushRx();
+	_prepareResponseWait();
+
+	// 发送命令帧
+	_inFlightCommand = frame_command(frame);
+	_commandSentTick = platform_get_tick();
+	if (!_uartTransmit(frame)) {
+		return Status::TransmitError;
+	}
+	return Status::OK;
+}
+
+/**
+ * @brief 等待并解析 _transmitCommand() 所发命令的响应
+ * @param responsePayload [out] 返回的响应负载 (指向帧重组器，下一次发送前有效)
+ * @param timeout 超时时间 (毫秒)，ADAPTIVE_TIMEOUT 表示使用该命令学习到的超时
+ * @return 命令执行结果
+ */
+FPM383C::CommandResult FPM383C::_awaitResponse(std::span<uint8_t> &responsePayload, uint32_t timeout) {
+	const uint32_t timeoutMs = _timeoutFor(_inFlightCommand, timeout);
+	const uint32_t startTick = platform_get_tick();
+	uint32_t elapsedMs = 0;
+	while (true) {
+		// 阻塞等待响应或超时
+		if (elapsedMs >= timeoutMs || !_waitForResponse(timeoutMs - elapsedMs)) {
+			// 超时，丢弃不完整的帧 (环形接收保持运行)
+			_flushRx();
+			return { Status::Timeout, ModuleErrorCode::None };
+		}
+
+		// 解析响应包
+		uint16_t ackCommand;
+		ModuleErrorCode errorCode;
+		if (!_parsePacket(_assembler.Frame(), ackCommand, errorCode, responsePayload)) {
+			// 响应包格式错误 (帧头或校验和不匹配)
+			return { Status::InvalidResponse, ModuleErrorCode::None };
+		}
+		if (ackCommand != _inFlightCommand) {
+			// 之前命令迟到的应答 (如超时后才到达的取消应答)，丢弃后在剩余时间内继续等待
+			_releaseFrame();
+			elapsedMs = platform_get_tick() - startTick;
+			continue;
+		}
+
+		_recordRtt(_inFlightCommand, _commandSentTick);
+		if (errorCode == ModuleErrorCode::None) {
+			return { Status::OK, ModuleErrorCode::None };
+		}
+		// 模块返回了错误码
+		return { Status::ModuleError, errorCode };
+	}
+}
+
+/**
+ * @brief 等待 _transmitCommand() 所发命令的响应，并将响应帧的槽位借给调用方
+ * @param response [out] 响应租约，解析成功 (含模块错误码) 时持有该帧
+ * @param timeout 超时时间 (毫秒)，ADAPTIVE_TIMEOUT 表示使用该命令学习到的超时
+ * @return 命令执行结果
+ */
+FPM383C::CommandResult FPM383C::_awaitResponse(ResponseLease &response, uint32_t timeout) {
+	response.Release();
+	std::span<uint8_t> payload;
+	const CommandResult result = _awaitResponse(payload, timeout);
+	if (result.first == Status::OK || result.first == Status::ModuleError) {
+		// 与接收回调互斥地借出槽位，负载仍指向该槽位
+		const uint32_t state = _enterCritical();
+		volatile bool *pin = _assembler.Lease();
+		_exitCritical(state);
+		if (pin != nullptr) {
+			response = ResponseLease(pin, payload);
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief 查找命令对应的往返时间估计器
+ * @return 不需要学习往返时间的命令返回 nullptr
+ */
+RttEstimator *FPM383C::_findRttEstimator(uint16_t command) {
+	const auto it = std::find(ADAPTIVE_COMMANDS.begin(), ADAPTIVE_COMMANDS.end(), command);
+	if (it == ADAPTIVE_COMMANDS.end()) {
+		return nullptr;
+	}
+	return &_rttEstimators[it - ADAPTIVE_COMMANDS.begin()];
+}
+
+/**
+ * @brief 计算命令实际使用的超时时间
+ * @param command 命令码
+ * @param timeout 调用方给出的超时，ADAPTIVE_TIMEOUT 表示自适应
+ * @return 超时时间 (毫秒)，不学习往返时间的命令在自适应时使用 DEFAULT_TIMEOUT_MS
+ */
+uint32_t FPM383C::_timeoutFor(uint16_t command, uint32_t timeout) {
+	if (timeout != ADAPTIVE_TIMEOUT) {
+		return timeout;
+	}
+	const RttEstimator *estimator = _findRttEstimator(command);
+	return estimator != nullptr ? estimator->GetTimeout(_timeoutFloorMs, _timeoutCeilingMs) : DEFAULT_TIMEOUT_MS;
+}
+
+/**
+ * @brief 记录一次往返时间样本
+ * @param command 命令码
+ * @param sentTick 命令发出时刻
+ * @details 往返时间以接收回调中记录的响应到达时刻为终点，不受调用任务被调度或处理其他数据的影响
+ */
+void FPM383C::_recordRtt(uint16_t command, uint32_t sentTick) {
+	RttEstimator *estimator = _findRttEstimator(command);
+	if (estimator != nullptr) {
+		estimator->AddSample(_responseTick - sentTick);
+	}
+}
+
+/**
+ * @brief 获取发送缓冲区的一半，模板传输时两半交替使用
+ * @param index 0 或 1
+ */
+std::span<uint8_t> FPM383C::_txHalf(size_t index) {
+	return std::span(_txBuffer).subspan((index & 1) * TX_HALF_BUFFER_SIZE, TX_HALF_BUFFER_SIZE);
+}
+
+/**
+ * @brief 处理自动注册流程 (同步阻塞模式)
+ * @param fingerId 要注册的指纹 ID (0xFFFF 表示自动分配)
+ * @param requiredPresses 需要采集的次数 (通常为 6)
+ * @param finalStatus [out] 最终注册状态
+ * @param progressCallback [可选] 进度回调函数
+ * @return 命令执行结果
+ * @details 注册过程说明:
+ *          1. 模块需要多次采集同一手指的指纹
+ *          2. 每次采集完成后返回一次响应，包含当前步骤和进度
+ *          3. Step=0xFF 时表示注册完成
+ *          4. 抬起手指检测标志设置为 1，要求用户每次采集后抬起手指
+ *          5. 超时时间较长 (15秒)，因为用户可能需要时间调整手指位置
+ *          响应负载格式 (5字节):
+ *          [0]: 步骤号 (1-N, 0xFF=完成)
+ *          [1-2]: 指纹 ID (big-endian)
+ *          [3]: 保留
+ *          [4]: 进度 (0-100)
+ */
+FPM383C::CommandResult FPM383C::_handleAutoEnrollment(uint16_t fingerId, uint8_t requiredPresses, EnrollStatus &finalStatus,
+	const EnrollCallback &progressCallback) {
+	if (_currentOperation != CurrentOperation::None) {
+		return { Status::Busy, ModuleErrorCode::None };
+	}
+
+	// 构造注册命令负载
+	const std::array<uint8_t, 4> payload = {
+		0x01, // 手指抬起检测标志: 0=不检测, 1=检测 (要求用户每次采集后抬起手指)
+		requiredPresses,
+		static_cast<uint8_t>(fingerId >> 8),
+		static_cast<uint8_t>(fingerId & 0xFF)
+	};
+
+	if (!_ensureRxRunning()) {
+		return { Status::ReceiveError, ModuleErrorCode::None };
+	}
+	_flushRx();
+	_prepareResponseWait();
+	if (!_uartTransmit(_prefixedFrame<CMD_AUTO_ENROLL>(std::span(payload)))) {
+		return { Status::TransmitError, ModuleErrorCode::None };
+	}
+
+	// 循环接收多次响应，直到注册完成
+	while (true) {
+		// 等待本次响应 (每一步都有完整的超时时间，避免多步操作累积超时)
+		if (!_waitForResponse(AUTO_ENROLL_TIMEOUT_MS)) {
+			// 超时，丢弃不完整的帧
+			_flushRx();
+			return { Status::Timeout, ModuleErrorCode::None };
+		}
+
+		uint16_t ackCmd;
+		ModuleErrorCode errCode;
+		std::span<uint8_t> respPayload;
+
+		if (_parsePacket(_assembler.Frame(), ackCmd, errCode, respPayload)) {
+			if (ackCmd != CMD_AUTO_ENROLL) {
+				// 之前命令迟到的应答，丢弃后继续等待本次注册的响应
+				_releaseFrame();
+				continue;
+			}
+			if (errCode != ModuleErrorCode::None) {
+				// 注册过程中发生错误，流程终止
+				finalStatus.IsComplete = true;
+				finalStatus.ErrorCode = errCode;
+				if (progressCallback) progressCallback(finalStatus);
+				return { Status::ModuleError, errCode };
+			}
+
+			// 解析注册进度响应
+			if (_decodeEnrollProgress(respPayload, finalStatus)) {
+				finalStatus.ErrorCode = ModuleErrorCode::None;
+
+				// 调用进度回调，通知上层应用当前状态
+				if (progressCallback) {
+					progressCallback(finalStatus);
+				}
+
+				if (finalStatus.IsComplete) {
+					return { Status::OK, ModuleErrorCode::None };
+				}
+			}
+		} else {
+			return { Status::InvalidResponse, ModuleErrorCode::None };
+		}
+
+		// 准备接收下一次响应 (环形接收一直在运行，已排队的下一步响应立即唤醒等待)
+		_releaseFrame();
+	}
+}
+
+/**
+ * @brief 处理新到达的接收数据
+ * @param size STM32: DMA 在环形缓冲区中的写入位置; ESP-IDF: 新到达的字节数
+ * @details 将自上次处理以来的新字节逐个送入帧重组器
+ *          STM32 循环 DMA 在 HT/TC/IDLE 事件时回调，写入位置到达缓冲区末尾时 size == RX_RING_SIZE
+ */
+void FPM383C::_consumeRx(uint16_t size) {
+#if defined(USE_HAL_DRIVER)
+	if (size > RX_RING_SIZE) return;
+	const uint16_t head = size % RX_RING_SIZE;
+	while (_rxTail != head) {
+		const uint8_t byte = _rxRing[_rxTail];
+		_rxTail = (_rxTail + 1) % RX_RING_SIZE;
+		if (_assembler.Feed(byte)) {
+			_onFrameAssembled();
+		}
+	}
+#elif defined(ESP_PLATFORM)
+	while (size > 0) {
+		const int readLen = uart_read_bytes(_huart, _rxRing.data(), std::min<size_t>(size, _rxRing.size()), 0);
+		if (readLen <= 0) break;
+		for (int i = 0; i < readLen; ++i) {
+			if (_assembler.Feed(_rxRing[i])) {
+				_onFrameAssembled();
+			}
+		}
+		size -= readLen;
+	}
+#endif
+}
+
+/**
+ * @brief 帧重组器得到完整帧后的分发
+ * @details 异步操作在接收回调中解析，结果写入完成队列由任务分发；同步操作唤醒等待中的任务
+ */
+void FPM383C::_onFrameAssembled() {
+	_responseTick = platform_get_tick();
+	// 异步操作模式: 在中断中解析响应，回调推迟到 DispatchCompletions()
+	while (_currentOperation != CurrentOperation::None && _assembler.HasFrame()) {
+		_handleAsyncResponse();
+	}
+	if (_assembler.HasFrame()) {
+		// 同步操作模式: 唤醒等待中的任务，由 _sendCommandAndGetResponse() 处理
+		_signalResponseReady();
+	}
+}
+
+/**
+ * @brief 处理异步操作的响应
+ * @details 该函数在 UART 接收中断回调中被调用
+ *          根据当前异步操作类型 (_currentOperation) 解析响应，结果写入完成队列，用户回调在 DispatchCompletions() 中执行
+ *          支持两种异步操作:
+ *          1. 异步匹配: 单次响应，完成后重置状态
+ *          2. 异步注册: 多次响应，直到注册完成才重置状态
+ */
+void FPM383C::_handleAsyncResponse() {
+	uint16_t ackCmd;
+	ModuleErrorCode errCode;
+	std::span<uint8_t> respPayload;
+
+	// 解析响应包
+	const bool isParsed = _parsePacket(_assembler.Frame(), ackCmd, errCode, respPayload);
+	_assembler.Release(); // 出队，负载在下方处理完毕前不会被覆盖 (仍在接收回调中)
+
+	if (isParsed && ackCmd != _inFlightCommand) {
+		// 不是在途命令的应答 (如取消后原操作迟到的 CmdAborted 应答)，丢弃
+		return;
+	}
+
+	if (_currentOperation == CurrentOperation::Batch) {
+		_handleBatchResponse(isParsed, errCode);
+		return;
+	}
+	if (_currentOperation == CurrentOperation::Cancelling) {
+		_handleCancelResponse(isParsed, errCode);
+		return;
+	}
+	if (_currentOperation == CurrentOperation::Recovering || _currentOperation == CurrentOperation::RecoveryWait) {
+		// 异步恢复的两次探测之间迟到的应答
+		return;
+	}
+
+	if (!isParsed || errCode != ModuleErrorCode::None) {
+		// 解析失败或模块报错，模块状态不再可信
+		InvalidateShadow();
+	}
+
+	if (!isParsed) {
+		// 解析失败，重置状态以允许后续操作
+		_markLinkDown();
+		_currentOperation = CurrentOperation::None;
+		return;
+	}
+
+	switch (_currentOperation) {
+	case CurrentOperation::AsyncMatch:
+	{
+		if (_asyncVerifyFingerId != MATCH_ANY_ID) {
+			if (errCode == ModuleErrorCode::CmdInvalid) {
+				// 模块不支持 1:1 比对: 记为不支持，直接改发 1:N 匹配，结果照常交出
+				_verifySupport = CommandSupport::Unsupported;
+				_asyncVerifyFingerId = MATCH_ANY_ID;
+				_startPendingMatch();
+				break;
+			}
+			_verifySupport = CommandSupport::Supported;
+		}
+
+		// 处理异步匹配响应
+		MatchResult result = { .ErrorCode = errCode };
+		if (errCode == ModuleErrorCode::None && _decodeMatch(respPayload, result)
+			&& _asyncVerifyFingerId != MATCH_ANY_ID && result.FingerId != _asyncVerifyFingerId) {
+			// 1:1 比对时模块返回的 ID 与请求不一致，按比对失败处理
+			result.IsSuccess = false;
+		}
+
+		// 结果交给任务中的匹配回调或等待中的协程
+		if (_hasMatchListener()) {
+			_postCompletion(CompletionRecord(result));
+		}
+		_currentOperation = CurrentOperation::None; // 匹配操作完成，重置状态
+		break;
+	}
+
+	case CurrentOperation::AsyncEnroll:
+	{
+		// 处理异步注册响应，每次进度应答都顺延截止时间
+		_asyncActivityTick = _responseTick;
+		EnrollStatus enrollStatus;
+		enrollStatus.ErrorCode = errCode;
+
+		if (errCode != ModuleErrorCode::None || !_decodeEnrollProgress(respPayload, enrollStatus)) {
+			// 发生错误，注册流程终止
+			enrollStatus.IsComplete = true;
+		}
+
+		// 进度交给任务中的进度回调
+		if (_enrollProgressCallback) {
+			_postCompletion(CompletionRecord(CompletionKind::EnrollProgress, enrollStatus));
+		}
+
+		if (enrollStatus.IsComplete) {
+			// 注册完成，交给任务中的完成回调或等待中的协程
+			if (_hasEnrollCompleteListener()) {
+				_postCompletion(CompletionRecord(CompletionKind::EnrollComplete, enrollStatus));
+			}
+			_currentOperation = CurrentOperation::None; // 注册完成，重置状态
+		}
+		// 注册未完成时无需重新启动接收，环形接收会继续收集下一次响应
+		break;
+	}
+	case CurrentOperation::None:
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief 设置当前异步操作的截止时间并启动定时器
+ * @param timeoutMs 从现在 (及异步注册的每次进度应答) 起算的截止时间
+ */
+void FPM383C::_armAsyncDeadline(uint32_t timeoutMs) {
+	_asyncTimeoutMs = timeoutMs;
+	_asyncActivityTick = platform_get_tick();
+	_startDeadlineTimer(timeoutMs);
+}
+
+/**
+ * @brief (重新) 启动单次截止时间定时器，首次调用时创建静态定时器
+ * @details 定时器回调在定时器服务任务中执行；操作正常完成时定时器不停止 (接收回调中不能操作定时器)，
+ *          到期时发现没有异步操作即忽略
+ */
+void FPM383C::_startDeadlineTimer(uint32_t timeoutMs) {
+#if defined(osCMSIS_FreeRTOS)
+	if (_asyncDeadlineTimer == nullptr) {
+		const osTimerAttr_t timerAttributes = {
+			.name = "FPM383CDeadline",
+			.cb_mem = &_asyncDeadlineTimerControlBlock,
+			.cb_size = sizeof(_asyncDeadlineTimerControlBlock)
+		};
+		_asyncDeadlineTimer = osTimerNew([](void *argument) { static_cast<FPM383C *>(argument)->_onAsyncDeadline(); },
+			osTimerOnce, this, &timerAttributes);
+	}
+	if (_asyncDeadlineTimer != nullptr) {
+		osTimerStart(_asyncDeadlineTimer, timeoutMs);
+	}
+#elif defined(ESP_PLATFORM)
+	if (_asyncDeadlineTimer == nullptr) {
+		_asyncDeadlineTimer = xTimerCreateStatic("FPM383CDeadline", pdMS_TO_TICKS(timeoutMs), pdFALSE, this,
+			[](TimerHandle_t timer) { static_cast<FPM383C *>(pvTimerGetTimerID(timer))->_onAsyncDeadline(); },
+			&_asyncDeadlineTimerControlBlock);
+	}
+	if (_asyncDeadlineTimer != nullptr) {
+		xTimerChangePeriod(_asyncDeadlineTimer, pdMS_TO_TICKS(timeoutMs), 0);
+	}
+#else
+	(void)timeoutMs; // 无 RTOS 时没有截止时间监督，由调用方使用 AbandonAsyncOperation()
+#endif
+}
+
+/**
+ * @brief 异步操作截止时间到达 (定时器服务任务中调用)
+ * @details 在临界区中确认操作仍未完成后中止接收并释放驱动，之后以 Timeout 结果写入完成队列
+ *          - 监督异步匹配/注册、不等待的取消、异步批处理 (含恢复探测) 和恢复等待，阻塞的 RunBatch() 自行计时
+ *          - 异步注册在截止时间内有进度应答时顺延，取消应答后发出的匹配按匹配的截止时间顺延
+ *          - 恢复等待结束不是失败，只通知分发任务继续恢复
+ */
+void FPM383C::_onAsyncDeadline() {
+	const uint32_t state = _enterCritical();
+	const CurrentOperation op = _currentOperation;
+	const bool isSupervised = op == CurrentOperation::AsyncMatch || op == CurrentOperation::AsyncEnroll
+		|| op == CurrentOperation::Cancelling || op == CurrentOperation::RecoveryWait
+		|| (op == CurrentOperation::Batch && _batchOwner != BatchOwner::Caller);
+	const uint32_t idleMs = platform_get_tick() - _asyncActivityTick;
+	if (!isSupervised || idleMs < _asyncTimeoutMs) {
+		_exitCritical(state);
+		if (isSupervised) {
+			_startDeadlineTimer(_asyncTimeoutMs - idleMs);
+		}
+		return;
+	}
+
+	const bool wasMatchPending = std::exchange(_isMatchPending, false);
+	if (op == CurrentOperation::RecoveryWait) {
+		_currentOperation = CurrentOperation::Recovering;
+	} else {
+		_abortRx();
+		_currentOperation = CurrentOperation::None;
+		if (op == CurrentOperation::Batch) {
+			if (_batchResult.FailedIndex == 0xFF) {
+				_batchResult.Result = { Status::Timeout, ModuleErrorCode::None };
+				_batchResult.FailedIndex = _batchIndex;
+			}
+			if (_batchOwner == BatchOwner::Recovery) {
+				_currentOperation = CurrentOperation::Recovering;
+			}
+		}
+	}
+	_exitCritical(state);
+
+	if (op == CurrentOperation::RecoveryWait) {
+		_postCompletion(CompletionRecord(CompletionKind::RecoveryWait, BatchResult{}));
+		return;
+	}
+
+	// 模块可能仍在执行该命令，状态不再可信
+	InvalidateShadow();
+	_markLinkDown();
+	if (op == CurrentOperation::Cancelling) {
+		// 取消无应答: 放弃原操作；首次取消即无应答时记为不支持
+		_postAborted(_cancelledOperation, ModuleErrorCode::None);
+		if (_cancelSupport == CommandSupport::Unknown) {
+			_cancelSupport = CommandSupport::Unsupported;
+		}
+	}
+	if (op == CurrentOperation::Batch) {
+		_reportBatch();
+	} else if ((op == CurrentOperation::AsyncMatch || wasMatchPending) && _hasMatchListener()) {
+		_postCompletion(CompletionRecord(MatchResult{ false, 0xFFFF, 0, ModuleErrorCode::None, Status::Timeout }));
+	} else if (op == CurrentOperation::AsyncEnroll && _hasEnrollCompleteListener()) {
+		_postCompletion(CompletionRecord(CompletionKind::EnrollComplete, EnrollStatus{ .IsComplete = true, .OperationStatus = Status::Timeout }));
+	}
+}
+
+/**
+ * @brief 写入一条完成记录并通知分发任务
+ * @details 接收回调和截止时间定时器任务都可能写入，因此在临界区中写入；队列已满时丢弃记录并计数，仍然通知
+ */
+void FPM383C::_postCompletion(const CompletionRecord &record) {
+	const uint32_t state = _enterCritical();
+	const bool isFull = static_cast<uint8_t>(_completionTail - _completionHead) >= COMPLETION_QUEUE_LENGTH;
+	if (isFull) {
+		_isrStats.DroppedCompletions++;
+	} else {
+		_completions[_completionTail % COMPLETION_QUEUE_LENGTH] = record;
+		_completionTail = _completionTail + 1;
+	}
+	_exitCritical(state);
+
+	if (_completionNotifier) {
+		_completionNotifier();
+	}
+}
+
+/**
+ * @brief 开始异步匹配或 1:1 比对
+ * @param fingerId 要比对的指纹 ID，MATCH_ANY_ID 表示 1:N 匹配
+ * @param preemptEnroll 是否先取消进行中的异步注册
+ * @details 取消注册时不等待应答，只记录 ID，匹配命令由接收回调在取消应答到达时发出 (见 _startPendingMatch())
+ */
+FPM383C::Status FPM383C::_startMatchOperation(uint16_t fingerId, bool preemptEnroll) {
+	if (_verifySupport == CommandSupport::Unsupported) {
+		fingerId = MATCH_ANY_ID; // 模块不支持 1:1 比对 (见 Verify())
+	}
+	if (preemptEnroll && _currentOperation == CurrentOperation::AsyncEnroll) {
+		_asyncVerifyFingerId = fingerId;
+		const Status cancelStatus = _startCancel(true);
+		if (cancelStatus == Status::Unsupported) {
+			return Status::Busy; // 模块不支持取消，不抢占，注册继续
+		}
+		if (cancelStatus != Status::OK) {
+			return cancelStatus;
+		}
+		// 注册恰好已经结束，直接开始匹配
+	}
+	if (_currentOperation != CurrentOperation::None) {
+		return Status::Busy;
+	}
+
+	_asyncVerifyFingerId = fingerId;
+	if (fingerId == MATCH_ANY_ID) {
+		return _startAsyncOperation(_fixedFrame<CMD_MATCH_ASYNC>(), CurrentOperation::AsyncMatch);
+	}
+	const std::array<uint8_t, 2> payload = {
+		static_cast<uint8_t>(fingerId >> 8),
+		static_cast<uint8_t>(fingerId & 0xFF)
+	};
+	return _startAsyncOperation(_prefixedFrame<CMD_VERIFY>(std::span(payload)), CurrentOperation::AsyncMatch);
+}
+
+/**
+ * @brief 发出取消命令，不等待应答
+ * @param isMatchPending 取消应答到达后是否由接收回调发出匹配命令 (ID 见 _asyncVerifyFingerId)
+ * @return AsyncInProgress 表示取消命令已发出，OK 表示没有异步操作，
+ *         Unsupported 表示模块不支持取消，Busy 表示取消命令未能发出 (如上一帧的发送 DMA 仍在进行)；后两者原操作继续
+ * @details 执行流程:
+ *          1. 在临界区中将当前操作切换为 Cancelling，接收回调此后只等待取消命令的应答
+ *          2. 发送取消命令，截止时间到达时由定时器释放驱动；发送失败时恢复原操作 (仍由其截止时间监督)
+ *          3. 模块确认取消后原操作以 Aborted 结果写入完成队列，模块拒绝取消时恢复原操作 (见 _handleCancelResponse())
+ *          取消命令未经实物验证，模块以 CmdInvalid 拒绝或首次取消无应答时记为不支持，之后不再发送
+ */
+FPM383C::Status FPM383C::_startCancel(bool isMatchPending) {
+	const uint32_t state = _enterCritical();
+	const CurrentOperation cancelled = _currentOperation;
+	const bool isAsync = cancelled == CurrentOperation::AsyncMatch || cancelled == CurrentOperation::AsyncEnroll;
+	const bool isUnsupported = _cancelSupport == CommandSupport::Unsupported;
+	if (isAsync && !isUnsupported) {
+		_cancelledOperation = cancelled;
+		_cancelledCommand = _inFlightCommand;
+		_cancelledTimeoutMs = _asyncTimeoutMs;
+		_cancelledActivityTick = _asyncActivityTick;
+		_currentOperation = CurrentOperation::Cancelling;
+		_inFlightCommand = CMD_CANCEL; // 此后只有取消命令的应答能结束取消
+		_isMatchPending = isMatchPending;
+	}
+	_exitCritical(state);
+
+	if (!isAsync) {
+		return Status::OK;
+	}
+	if (isUnsupported) {
+		_cancelResult = { Status::Unsupported, ModuleErrorCode::None };
+		return Status::Unsupported;
+	}
+
+	// 发送缓冲区前半部分可能仍被原操作的帧占用，非默认密码时在后半部分构造取消命令
+	std::span<const uint8_t> frame = FPM383CFrame::Frame<CMD_CANCEL, DEFAULT_PASSWORD>;
+	if (_password != DEFAULT_PASSWORD) {
+		const std::span<uint8_t> buffer = _txHalf(1);
+		frame = buffer.first(_buildPacket(buffer, CMD_CANCEL, {}));
+	}
+
+	_cancelResult = { Status::Timeout, ModuleErrorCode::None };
+	_armAsyncDeadline(CANCEL_TIMEOUT_MS);
+	if (_uartTransmit(frame)) {
+		return Status::AsyncInProgress;
+	}
+
+	// 发送失败 (HAL 忙或出错)，模块仍在执行原操作: 在临界区中恢复原操作，不释放驱动
+	const uint32_t restoreState = _enterCritical();
+	if (_currentOperation == CurrentOperation::Cancelling) {
+		_restoreCancelledOperation();
+	}
+	_exitCritical(restoreState);
+	_cancelResult = { Status::Busy, ModuleErrorCode::None };
+	return Status::Busy;
+}
+
+/**
+ * @brief 取消未能生效时恢复被取消的操作 (临界区或接收回调中调用)
+ * @details 恢复原操作的命令码和截止时间，截止时间定时器到期时按剩余时间重新启动
+ */
+void FPM383C::_restoreCancelledOperation() {
+	_currentOperation = _cancelledOperation;
+	_inFlightCommand = _cancelledCommand;
+	_asyncTimeoutMs = _cancelledTimeoutMs;
+	_asyncActivityTick = _cancelledActivityTick;
+	_isMatchPending = false;
+}
+
+/**
+ * @brief 处理取消期间收到的响应
+ * @details 在 UART 接收回调中被调用，只有取消命令本身的应答结束取消；
+ *          原操作以 CmdAborted 结束的应答、取消之前已在途的进度和结果已在 _handleAsyncResponse() 中按命令码丢弃
+ *          - 模块确认取消: 原操作以 Aborted 结果写入完成队列
+ *          - 模块拒绝取消: 原操作仍在模块上执行，恢复原操作 (CmdInvalid 时记为不支持取消)
+ *          - 阻塞的 Cancel(): 唤醒调用任务
+ *          - 抢占注册的匹配: 取消成功时直接发出匹配命令，模块拒绝取消时注册继续，匹配以 Busy 结果回调
+ */
+void FPM383C::_handleCancelResponse(bool isParsed, ModuleErrorCode errCode) {
+	if (!isParsed) {
+		return;
+	}
+	const bool isRejected = errCode != ModuleErrorCode::None && errCode != ModuleErrorCode::CmdAborted;
+	_cancelSupport = errCode == ModuleErrorCode::CmdInvalid ? CommandSupport::Unsupported : CommandSupport::Supported;
+	const bool isMatchPending = std::exchange(_isMatchPending, false);
+	if (isRejected) {
+		_cancelResult = { Status::ModuleError, errCode };
+		_restoreCancelledOperation();
+	} else {
+		_cancelResult = { Status::OK, ModuleErrorCode::None };
+		_currentOperation = CurrentOperation::None;
+		_postAborted(_cancelledOperation, ModuleErrorCode::CmdAborted);
+	}
+
+	if (!isMatchPending) {
+		_signalResponseReady();
+		return;
+	}
+
+	_updateShadow(CMD_CANCEL, {}, _cancelResult.first);
+	if (!isRejected) {
+		_startPendingMatch();
+		return;
+	}
+	if (_hasMatchListener()) {
+		_postCompletion(CompletionRecord(MatchResult{ .ErrorCode = errCode, .OperationStatus = Status::Busy }));
+	}
+}
+
+/**
+ * @brief 取消应答到达后发出等待中的匹配命令，或 1:1 比对被拒绝后改发 1:N 匹配 (接收回调中调用)
+ * @details 之前的命令已被模块完整接收，发送缓冲区前一半空闲，在其中构造匹配或 1:1 比对命令；
+ *          截止时间顺延为 ASYNC_MATCH_TIMEOUT_MS (定时器在取消的截止时间到达时按剩余时间重新启动)
+ */
+void FPM383C::_startPendingMatch() {
+	const std::array<uint8_t, 2> verifyPayload = {
+		static_cast<uint8_t>(_asyncVerifyFingerId >> 8),
+		static_cast<uint8_t>(_asyncVerifyFingerId & 0xFF)
+	};
+	const bool isVerify = _asyncVerifyFingerId != MATCH_ANY_ID;
+	const uint16_t command = isVerify ? CMD_VERIFY : CMD_MATCH_ASYNC;
+	const std::span<const uint8_t> payload = isVerify ? std::span<const uint8_t>(verifyPayload) : std::span<const uint8_t>();
+	const std::span<uint8_t> buffer = _txHalf(0);
+	const size_t frameSize = _buildPacket(buffer, command, payload);
+
+	_inFlightCommand = command;
+	_currentOperation = CurrentOperation::AsyncMatch;
+	_asyncTimeoutMs = ASYNC_MATCH_TIMEOUT_MS;
+	_asyncActivityTick = _responseTick;
+
+	const Status status = _uartTransmit(buffer.first(frameSize)) ? Status::AsyncInProgress : Status::TransmitError;
+	_updateShadow(command, payload, status);
+	if (status != Status::AsyncInProgress) {
+		_currentOperation = CurrentOperation::None;
+		if (_hasMatchListener()) {
+			_postCompletion(CompletionRecord(MatchResult{ .OperationStatus = status }));
+		}
+	}
+}
+
+/**
+ * @brief 启动批处理，发出第一条命令
+ * @param commands 要执行的命令列表
+ * @param abortOnFailure 遇到第一条失败的命令时是否中止后续命令
+ * @return AsyncInProgress 表示已启动，OK 表示所有命令均被省略 (结果已在 _batchResult 中)，其余为失败原因
+ */
+FPM383C::Status FPM383C::_startBatch(std::span<const BatchCommand> commands, bool abortOnFailure) {
+	if (_currentOperation != CurrentOperation::None || commands.empty() || commands.size() >= 0xFF) {
+		return Status::Busy;
+	}
+	if (!_ensureRxRunning()) {
+		return Status::ReceiveError;
+	}
+	_flushRx();
+
+	_batchCommands = commands;
+	_batchResult = {};
+	_batchIndex = 0;
+	_batchAbortOnFailure = abortOnFailure;
+	_currentOperation = CurrentOperation::Batch;
+
+	const Status status = _advanceBatch();
+	if (status != Status::AsyncInProgress) {
+		// 发送失败，或所有命令的效果均已生效 (OK)
+		_currentOperation = CurrentOperation::None;
+	}
+	return status;
+}
+
+/**
+ * @brief 启动结果交给回调或异步恢复的批处理
+ * @param owner 结果的去向 (Callback 或 Recovery)
+ * @param timeoutMs 整批的截止时间
+ * @return AsyncInProgress 表示已启动 (所有命令均被省略时结果已写入完成队列)，其余为失败原因
+ */
+FPM383C::Status FPM383C::_startOwnedBatch(std::span<const BatchCommand> commands, bool abortOnFailure, BatchOwner owner,
+	uint32_t timeoutMs) {
+	if (_currentOperation != CurrentOperation::None || commands.empty()) {
+		return Status::Busy;
+	}
+	_batchOwner = owner;
+	// 先设置截止时间: 第一条命令发出后整批可能在接收回调中立即完成
+	_armAsyncDeadline(timeoutMs);
+	const Status status = _startBatch(commands, abortOnFailure);
+	if (status == Status::OK) {
+		_reportBatch();
+		return Status::AsyncInProgress;
+	}
+	return status;
+}
+
+/**
+ * @brief 整批的超时时间: 每条命令各自超时 (自适应或 DEFAULT_TIMEOUT_MS) 之和
+ */
+uint32_t FPM383C::_batchTimeout(std::span<const BatchCommand> commands) {
+	uint32_t timeout = 0;
+	for (const BatchCommand &command : commands) {
+		timeout += _timeoutFor(command.Command, ADAPTIVE_TIMEOUT);
+	}
+	return timeout;
+}
+
+/**
+ * @brief 处理批处理中一条命令的响应
+ * @param isParsed 响应包是否解析成功
+ * @param errCode 模块返回的错误码
+ * @details 在 UART 接收回调中被调用，记录结果后直接发出下一条命令，整批结束时唤醒调用任务
+ */
+void FPM383C::_handleBatchResponse(bool isParsed, ModuleErrorCode errCode) {
+	Status status = Status::OK;
+	if (!isParsed) {
+		status = Status::InvalidResponse;
+		errCode = ModuleErrorCode::None;
+	} else if (errCode != ModuleErrorCode::None) {
+		status = Status::ModuleError;
+	}
+
+	const BatchCommand &command = _batchCommands[_batchIndex];
+	_updateShadow(command.Command, { command.Payload.data(), command.PayloadLength }, status);
+	if (isParsed) {
+		_recordRtt(command.Command, _commandSentTick);
+	}
+
+	_batchResult.CompletedCount++;
+	if (status != Status::OK && _batchResult.FailedIndex == 0xFF) {
+		_batchResult.Result = { status, errCode };
+		_batchResult.FailedIndex = _batchIndex;
+	}
+
+	_batchIndex++;
+	if (status != Status::OK && _batchAbortOnFailure) {
+		_finishBatch();
+		return;
+	}
+
+	const Status advanceStatus = _advanceBatch();
+	if (advanceStatus == Status::AsyncInProgress) {
+		return;
+	}
+	if (advanceStatus == Status::TransmitError && _batchResult.FailedIndex == 0xFF) {
+		_batchResult.Result = { Status::TransmitError, ModuleErrorCode::None };
+		_batchResult.FailedIndex = _batchIndex;
+	}
+	_finishBatch();
+}
+
+/**
+ * @brief 跳过批处理中效果已生效的命令，发出下一条需要发送的命令
+ * @return AsyncInProgress 表示已发出，OK 表示已没有需要发送的命令，TransmitError 表示发送失败
+ */
+FPM383C::Status FPM383C::_advanceBatch() {
+	while (_batchIndex < _batchCommands.size()) {
+		const BatchCommand &command = _batchCommands[_batchIndex];
+		if (!_isRedundant(command.Command, { command.Payload.data(), command.PayloadLength })) {
+			return _transmitBatchCommand() ? Status::AsyncInProgress : Status::TransmitError;
+		}
+		// 省略的命令视为已成功完成
+		_shadowStats.ElidedCommands++;
+		_batchResult.CompletedCount++;
+		_batchIndex++;
+	}
+	return Status::OK;
+}
+
+/**
+ * @brief 发送批处理中的当前命令
+ * @return 是否发送成功
+ * @details 上一条命令的响应已到达，说明其发送早已完成，可以安全复用发送缓冲区
+ */
+bool FPM383C::_transmitBatchCommand() {
+	const BatchCommand &command = _batchCommands[_batchIndex];
+	const size_t packetSize = _buildPacket(command.Command, { command.Payload.data(), command.PayloadLength });
+	_inFlightCommand = command.Command;
+	_commandSentTick = platform_get_tick();
+	return _uartTransmit({ _txBuffer.data(), packetSize });
+}
+
+/**
+ * @brief 结束批处理并交出结果 (接收回调中调用)
+ */
+void FPM383C::_finishBatch() {
+	_currentOperation = _batchOwner == BatchOwner::Recovery ? CurrentOperation::Recovering : CurrentOperation::None;
+	_reportBatch();
+}
+
+/**
+ * @brief 按批处理的所有者交出结果: 唤醒 RunBatch() 的调用任务，或写入完成队列
+ */
+void FPM383C::_reportBatch() {
+	switch (_batchOwner) {
+	case BatchOwner::Callback:
+		if (_hasBatchListener()) {
+			_postCompletion(CompletionRecord(CompletionKind::Batch, _batchResult));
+		}
+		break;
+	case BatchOwner::Recovery:
+		_postCompletion(CompletionRecord(CompletionKind::RecoveryProbe, _batchResult));
+		break;
+	case BatchOwner::Caller:
+	default:
+		_signalResponseReady();
+		break;
+	}
+}
+
+/**
+ * @brief 以 Aborted 结果结束被取消或放弃的异步操作
+ * @param cancelled 被取消或放弃的操作
+ * @param errCode 写入结果的模块错误码 (模块确认取消时为 CmdAborted)
+ * @details 结果写入完成队列，由 DispatchCompletions() 交给匹配回调或注册完成回调
+ */
+void FPM383C::_postAborted(CurrentOperation cancelled, ModuleErrorCode errCode) {
+	if (cancelled == CurrentOperation::AsyncMatch && _hasMatchListener()) {
+		_postCompletion(CompletionRecord(MatchResult{ false, 0xFFFF, 0, errCode, Status::Aborted }));
+	} else if (cancelled == CurrentOperation::AsyncEnroll && _hasEnrollCompleteListener()) {
+		_postCompletion(CompletionRecord(CompletionKind::EnrollComplete, EnrollStatus{ .IsComplete = true, .ErrorCode = errCode, .OperationStatus = Status::Aborted }));
 	}
+}
 
-	_isResponseReady = false;
-	_lastRxSize = 0;
+// ============================================================================
+// 链路恢复
+// ============================================================================
 
-	// 启动 UART DMA 接收 (空闲中断模式)
-	if (!_uartReceive()) {
-		return { Status::ReceiveError, ModuleErrorCode::None };
+/**
+ * @brief 恢复中断的链路 (阻塞)
+ * @details 状态机: FlushRx -> Resync -> PowerCycle，每一级失败后升级到下一级，成功时记录中断时长
+ *          中断时长从首次检测到中断 (_markLinkDown) 算起，到心跳确认恢复为止
+ */
+FPM383C::RecoveryLevel FPM383C::Recover() {
+	if (!_isLinkDown) {
+		return RecoveryLevel::None;
 	}
 
-	// 构造并发送命令包
-	size_t packetSize = _buildPacket(command, payload);
-	if (!_uartTransmit(packetSize)) {
-		return { Status::TransmitError, ModuleErrorCode::None };
+	// 放弃无响应的异步操作，释放驱动
+	AbandonAsyncOperation();
+	if (_currentOperation != CurrentOperation::None) {
+		return RecoveryLevel::Failed;
 	}
 
-	// 阻塞等待响应或超时
-	uint32_t startTime = platform_get_tick();
-	while (!_isResponseReady) {
-		if (platform_get_tick() - startTime > timeout) {
-			// 超时，中止接收操作
-#if defined(USE_HAL_DRIVER)
-			HAL_UART_AbortReceive_IT(_huart);
-#elif defined(ESP_PLATFORM)
-			uart_flush(_huart);
-#endif
-			return { Status::Timeout, ModuleErrorCode::None };
+	_beginRecovery();
+	uint32_t powerOffMs = 0;
+	while (_nextRecoveryProbe(powerOffMs)) {
+		if (powerOffMs != 0) {
+			platform_delay(powerOffMs);
+			_powerOnForRecovery();
 		}
-		platform_delay(5); // 短暂延时，避免 CPU 空转
-	}
-
-	// 解析响应包
-	uint16_t ackCommand;
-	ModuleErrorCode errorCode;
-	if (_parsePacket({ _rxBuffer.data(), _lastRxSize }, ackCommand, errorCode, responsePayload)) {
-		if (errorCode == ModuleErrorCode::None) {
-			return { Status::OK, ModuleErrorCode::None };
+		if (_probeLink(RECOVERY_PROBE_TIMEOUT_MS)) {
+			return _finishRecovery(true);
 		}
-		// 模块返回了错误码
-		return { Status::ModuleError, errorCode };
 	}
-
-	// 响应包格式错误 (帧头或校验和不匹配)
-	return { Status::InvalidResponse, ModuleErrorCode::None };
+	return _finishRecovery(false);
 }
 
 /**
- * @brief 处理自动注册流程 (同步阻塞模式)
- * @param fingerId 要注册的指纹 ID (0xFFFF 表示自动分配)
- * @param requiredPresses 需要采集的次数 (通常为 6)
- * @param finalStatus [out] 最终注册状态
- * @param progressCallback [可选] 进度回调函数
- * @return 命令执行结果
- * @details 注册过程说明:
- *          1. 模块需要多次采集同一手指的指纹
- *          2. 每次采集完成后返回一次响应，包含当前步骤和进度
- *          3. Step=0xFF 时表示注册完成
- *          4. 抬起手指检测标志设置为 1，要求用户每次采集后抬起手指
- *          5. 超时时间较长 (15秒)，因为用户可能需要时间调整手指位置
- *          响应负载格式 (5字节):
- *          [0]: 步骤号 (1-N, 0xFF=完成)
- *          [1-2]: 指纹 ID (big-endian)
- *          [3]: 保留
- *          [4]: 进度 (0-100)
+ * @brief 开始异步恢复
+ * @details 与 Recover() 共用恢复进度，每次探测结束后由 DispatchCompletions() 推进；
+ *          恢复期间当前操作始终不为 None (Recovering、RecoveryWait 或探测批处理)，其他命令返回 Busy
  */
-FPM383C::CommandResult FPM383C::_handleAutoEnrollment(uint16_t fingerId, uint8_t requiredPresses, EnrollStatus &finalStatus,
-	const std::function<void(const EnrollStatus &)> &progressCallback) {
+FPM383C::Status FPM383C::StartRecovery() {
+	if (!_isLinkDown) {
+		return Status::OK;
+	}
+
+	// 放弃无响应的异步操作，释放驱动
+	AbandonAsyncOperation();
 	if (_currentOperation != CurrentOperation::None) {
-		return { Status::Busy, ModuleErrorCode::None };
+		return Status::Busy;
 	}
 
-	// 构造注册命令负载
-	const std::array<uint8_t, 4> payload = {
-		0x01, // 手指抬起检测标志: 0=不检测, 1=检测 (要求用户每次采集后抬起手指)
-		requiredPresses,
-		static_cast<uint8_t>(fingerId >> 8),
-		static_cast<uint8_t>(fingerId & 0xFF)
-	};
+	_beginRecovery();
+	_currentOperation = CurrentOperation::Recovering;
+	_advanceRecovery();
+	return Status::AsyncInProgress;
+}
 
-	_isResponseReady = false;
-	if (!_uartReceive()) {
-		return { Status::ReceiveError, ModuleErrorCode::None };
-	}
-	size_t packetSize = _buildPacket(CMD_AUTO_ENROLL, payload);
-	if (!_uartTransmit(packetSize)) {
-		return { Status::TransmitError, ModuleErrorCode::None };
+void FPM383C::_markLinkDown() {
+	if (!_isLinkDown) {
+		_linkDownTick = platform_get_tick();
+		_isLinkDown = true;
 	}
+}
 
-	uint32_t startTime = platform_get_tick();
+bool FPM383C::_probeLink(uint32_t timeout) {
+	std::span<uint8_t> response;
+	const Status status = _sendCommandAndGetResponse(_fixedFrame<CMD_HEARTBEAT>(), response, timeout).first;
+	// 模块返回错误码同样说明链路是通的
+	return status == Status::OK || status == Status::ModuleError;
+}
 
-	// 循环接收多次响应，直到注册完成
-	while (true) {
-		// 等待本次响应
-		while (!_isResponseReady) {
-			if (platform_get_tick() - startTime > AUTO_ENROLL_TIMEOUT_MS) {
-				// 超时，中止操作
-#if defined(USE_HAL_DRIVER)
-				HAL_UART_AbortReceive_IT(_huart);
-#elif defined(ESP_PLATFORM)
-				uart_flush(_huart);
-#endif
-				return { Status::Timeout, ModuleErrorCode::None };
-			}
-			platform_delay(1);
+bool FPM383C::_awaitPowerUp() {
+	// 模块启动期间的心跳会被丢弃，重复探测直到应答，只等待实际需要的上电时间
+	const uint32_t startTick = platform_get_tick();
+	do {
+		if (_probeLink(RECOVERY_PROBE_TIMEOUT_MS)) {
+			return true;
 		}
+	} while (platform_get_tick() - startTick < POWER_UP_TIMEOUT_MS);
+	return false;
+}
 
-		uint16_t ackCmd;
-		ModuleErrorCode errCode;
-		std::span<uint8_t> respPayload;
+void FPM383C::_beginRecovery() {
+	const RecoveryLevel maxLevel = _powerPin != nullptr ? RecoveryLevel::PowerCycle : RecoveryLevel::Resync;
+	RecoveryLevel level = RecoveryLevel::FlushRx;
+	if (_lastRecoveryLevel != RecoveryLevel::None && _linkDownTick - _lastRecoveryTick < RECOVERY_ESCALATION_WINDOW_MS) {
+		// 上一次恢复后很快再次中断，同级恢复不足以解决问题
+		level = static_cast<RecoveryLevel>(std::to_underlying(_lastRecoveryLevel) + 1);
+	}
+	_recovery = { .Level = std::min(level, maxLevel), .MaxLevel = maxLevel, .BaudRate = _baudRate };
+}
 
-		if (_parsePacket({ _rxBuffer.data(), _lastRxSize }, ackCmd, errCode, respPayload)) {
-			if (errCode != ModuleErrorCode::None) {
-				// 注册过程中发生错误，流程终止
-				finalStatus.IsComplete = true;
-				finalStatus.ErrorCode = errCode;
-				if (progressCallback) progressCallback(finalStatus);
-				return { Status::ModuleError, errCode };
+/**
+ * @brief 推进恢复进度到下一次心跳探测
+ * @param powerOffMs [out] 探测前需要保持断电的时间，不为 0 时调用方等待该时间后调用 _powerOnForRecovery()
+ * @return false 表示所有级别都已失败
+ * @details 各级别的探测:
+ *          - FlushRx: 丢弃接收残留后探测一次
+ *          - Resync: 依次以开始恢复时的、协商目标和出厂波特率重新初始化 UART 后各探测一次
+ *          - PowerCycle: 断电后重新上电，在 POWER_UP_TIMEOUT_MS 内轮流以上述波特率持续探测
+ */
+bool FPM383C::_nextRecoveryProbe(uint32_t &powerOffMs) {
+	powerOffMs = 0;
+
+	// 当前波特率之外，模块可能已切换到协商目标波特率 (应答了设置命令但主机未能确认)，也可能已恢复出厂波特率
+	const std::array<uint32_t, 3> candidates = { _recovery.BaudRate, _targetBaudRate, DEFAULT_BAUD_RATE };
+	std::array<uint32_t, 3> baudRates{};
+	size_t baudRateCount = 0;
+	for (const uint32_t baudRate : candidates) {
+		const auto end = baudRates.begin() + baudRateCount;
+		if (baudRate != 0 && std::find(baudRates.begin(), end, baudRate) == end) {
+			baudRates[baudRateCount++] = baudRate;
+		}
+	}
+
+	while (_recovery.Level <= _recovery.MaxLevel) {
+		const uint8_t step = _recovery.Step++;
+		switch (_recovery.Level) {
+		case RecoveryLevel::FlushRx:
+			if (step == 0) {
+				// 丢弃半帧和残留数据 (发送心跳前会重新启动已停止的环形接收)
+				_flushRx();
+				return true;
 			}
+			break;
+		case RecoveryLevel::Resync:
+			if (step < baudRateCount) {
+				_setUartBaudRate(baudRates[step]);
+				return true;
+			}
+			break;
+		case RecoveryLevel::PowerCycle:
+			if (step == 0) {
+				_setPower(false);
+				_recovery.IsPoweredOff = true;
+				// 模块将重启，LED、休眠等状态均已复位
+				InvalidateShadow();
+				powerOffMs = POWER_OFF_MS;
+				return true;
+			}
+			if (platform_get_tick() - _recovery.PowerOnTick < POWER_UP_TIMEOUT_MS) {
+				// 模块启动期间的心跳会被丢弃，重复探测直到应答，只等待实际需要的上电时间
+				_setUartBaudRate(baudRates[(step - 1) % baudRateCount]);
+				return true;
+			}
+			break;
+		default:
+			break;
+		}
+		_recovery.Level = static_cast<RecoveryLevel>(std::to_underlying(_recovery.Level) + 1);
+		_recovery.Step = 0;
+	}
+	return false;
+}
 
-			// 解析注册进度响应
-			if (respPayload.size() >= 5) {
-				finalStatus.Step = respPayload[0];
-				finalStatus.FingerId = (static_cast<uint16_t>(respPayload[1]) << 8) | respPayload[2];
-				finalStatus.Progress = respPayload[4];
-				finalStatus.ErrorCode = ModuleErrorCode::None;
+void FPM383C::_powerOnForRecovery() {
+	_setPower(true);
+	_recovery.IsPoweredOff = false;
+	_recovery.PowerOnTick = platform_get_tick();
+}
 
-				// Step=0xFF 表示注册完成
-				finalStatus.IsComplete = (finalStatus.Step == 0xFF);
+FPM383C::RecoveryLevel FPM383C::_finishRecovery(bool isRecovered) {
+	if (!isRecovered) {
+		_recoveryStats.Failures++;
+		return RecoveryLevel::Failed;
+	}
 
-				// 调用进度回调，通知上层应用当前状态
-				if (progressCallback) {
-					progressCallback(finalStatus);
-				}
+	const RecoveryLevel level = _recovery.Level;
+	const uint32_t now = platform_get_tick();
+	const uint32_t outageMs = now - _linkDownTick;
+	_recoveryStats.Recoveries[std::to_underlying(level) - std::to_underlying(RecoveryLevel::FlushRx)]++;
+	_recoveryStats.LastOutageMs = outageMs;
+	_recoveryStats.MaxOutageMs = std::max(_recoveryStats.MaxOutageMs, outageMs);
+	_lastRecoveryLevel = level;
+	_lastRecoveryTick = now;
+	_isLinkDown = false;
+	return level;
+}
 
-				if (finalStatus.IsComplete) {
-					return { Status::OK, ModuleErrorCode::None };
-				}
-			}
-		} else {
-			return { Status::InvalidResponse, ModuleErrorCode::None };
-		}
+/**
+ * @brief 异步恢复: 发出下一次探测，断电时先进入等待，所有级别都失败时结束
+ */
+void FPM383C::_advanceRecovery() {
+	uint32_t powerOffMs = 0;
+	if (!_nextRecoveryProbe(powerOffMs)) {
+		_completeRecovery(false);
+		return;
+	}
+	if (powerOffMs != 0) {
+		_waitForRecovery(powerOffMs);
+		return;
+	}
+	_startRecoveryProbe();
+}
 
-		// 准备接收下一次响应
-		_isResponseReady = false;
-		if (!_uartReceive()) return { Status::ReceiveError, ModuleErrorCode::None };
-		// 重置超时计时器，避免多步操作累积超时
-		startTime = platform_get_tick();
+/**
+ * @brief 异步恢复: 以单条心跳的批处理探测链路，结果以 RecoveryProbe 记录写入完成队列
+ * @details 发送失败时等待一次探测的时间后继续，避免在上电窗口内空转
+ */
+void FPM383C::_startRecoveryProbe() {
+	static constexpr std::array<BatchCommand, 1> probe = { BatchCommand::Heartbeat() };
+
+	// 批处理要求驱动空闲，本函数返回前不会有其他命令插入
+	_currentOperation = CurrentOperation::None;
+	const Status status = _startOwnedBatch(probe, true, BatchOwner::Recovery, RECOVERY_PROBE_TIMEOUT_MS);
+	if (status != Status::AsyncInProgress) {
+		_currentOperation = CurrentOperation::Recovering;
+		_waitForRecovery(RECOVERY_PROBE_TIMEOUT_MS);
 	}
 }
 
 /**
- * @brief 处理异步操作的响应
- * @details 该函数在 UART 接收中断回调中被调用
- *          根据当前异步操作类型 (_currentOperation) 解析响应并调用对应的用户回调函数
- *          支持两种异步操作:
- *          1. 异步匹配: 单次响应，完成后重置状态
- *          2. 异步注册: 多次响应，直到注册完成才重置状态
+ * @brief 异步恢复: 等待指定时间，到期时由截止时间定时器写入 RecoveryWait 记录
  */
-void FPM383C::_handleAsyncResponse() {
-	uint16_t ackCmd;
-	ModuleErrorCode errCode;
-	std::span<uint8_t> respPayload;
+void FPM383C::_waitForRecovery(uint32_t timeoutMs) {
+	_currentOperation = CurrentOperation::RecoveryWait;
+	_armAsyncDeadline(timeoutMs);
+}
 
-	// 解析响应包
-	if (!_parsePacket({ _rxBuffer.data(), _lastRxSize }, ackCmd, errCode, respPayload)) {
-		// 解析失败，重置状态以允许后续操作
-		_currentOperation = CurrentOperation::None;
-		return;
+/**
+ * @brief 异步恢复: 记录统计，释放驱动并交给等待中的协程或回调
+ */
+void FPM383C::_completeRecovery(bool isRecovered) {
+	_currentOperation = CurrentOperation::None;
+	const RecoveryLevel level = _finishRecovery(isRecovered);
+	if (!_resumeWaiter(_recoveryWaiter, level) && _recoveryCallback) {
+		_recoveryCallback(level);
 	}
+}
 
-	switch (_currentOperation) {
-	case CurrentOperation::AsyncMatch:
-	{
-		// 处理异步匹配响应
-		MatchResult result = { false, 0, 0 };
-		if (errCode == ModuleErrorCode::None && respPayload.size() >= 5) {
-			result.IsSuccess = (respPayload[0] == 1);
-			if (result.IsSuccess) {
-				// 解析匹配分数和指纹 ID
-				result.MatchScore = (static_cast<uint16_t>(respPayload[1]) << 8) | respPayload[2];
-				result.FingerId = (static_cast<uint16_t>(respPayload[3]) << 8) | respPayload[4];
-			}
-		} else if (errCode == ModuleErrorCode::MatchFailedLibEmpty) {
-			result.IsSuccess = false;
-		}
+// ============================================================================
+// 模块状态影子
+// ============================================================================
 
-		// 调用匹配回调函数通知结果
-		if (_matchCallback) {
-			_matchCallback(result);
-		}
-		_currentOperation = CurrentOperation::None; // 匹配操作完成，重置状态
-		break;
-	}
+void FPM383C::InvalidateShadow() {
+	_shadow = {};
+	_shadowStats.Invalidations++;
+}
 
-	case CurrentOperation::AsyncEnroll:
+/**
+ * @brief 判断命令的效果是否已经生效
+ * @param command 命令码
+ * @param payload 命令负载
+ * @return true 表示可以省略该命令
+ */
+bool FPM383C::_isRedundant(uint16_t command, std::span<const uint8_t> payload) const {
+	switch (command) {
+	case CMD_SET_LED_CONTROL:
+		return _shadow.IsLEDKnown && std::ranges::equal(payload, _shadow.LEDPayload);
+	case CMD_ENTER_SLEEP_MODE:
 	{
-		// 处理异步注册响应
-		EnrollStatus enrollStatus;
-		enrollStatus.ErrorCode = errCode;
+		const bool isDeepSleep = !payload.empty() && payload[0] == 0x01;
+		return _shadow.Sleep == (isDeepSleep ? SleepState::DeepSleeping : SleepState::Sleeping);
+	}
+	default:
+		return false;
+	}
+}
 
-		if (errCode == ModuleErrorCode::None && respPayload.size() >= 5) {
-			enrollStatus.Step = respPayload[0];
-			enrollStatus.FingerId = (static_cast<uint16_t>(respPayload[1]) << 8) | respPayload[2];
-			enrollStatus.Progress = respPayload[4];
-			enrollStatus.IsComplete = (enrollStatus.Step == 0xFF);
-		} else {
-			// 发生错误，注册流程终止
-			enrollStatus.IsComplete = true;
-		}
+/**
+ * @brief 根据命令及其结果更新状态影子
+ * @param command 命令码
+ * @param payload 命令负载
+ * @param status 命令结果 (异步操作启动成功时为 AsyncInProgress)
+ */
+void FPM383C::_updateShadow(uint16_t command, std::span<const uint8_t> payload, Status status) {
+	if (command == CMD_MATCH_SYNC || command == CMD_MATCH_ASYNC || command == CMD_VERIFY || command == CMD_AUTO_ENROLL
+		|| command == CMD_ENTER_SLEEP_MODE) {
+		// 模块中最近一次匹配的特征已被覆盖 (或可能已丢失)，待执行的自学习失效
+		_deferredFeatureUpdateId = NO_DEFERRED_FEATURE_UPDATE;
+	}
 
-		// 调用进度回调
-		if (_enrollProgressCallback) {
-			_enrollProgressCallback(enrollStatus);
+	if (status != Status::OK && status != Status::AsyncInProgress) {
+		InvalidateShadow();
+		if (is_link_failure(status)) {
+			_markLinkDown();
 		}
+		return;
+	}
 
-		if (enrollStatus.IsComplete) {
-			// 注册完成，调用完成回调
-			if (_enrollCompleteCallback) {
-				_enrollCompleteCallback(enrollStatus);
-			}
-			_currentOperation = CurrentOperation::None; // 注册完成，重置状态
-		} else {
-			// 注册未完成，继续等待下一次响应
-			if (!_uartReceive()) {
-				_currentOperation = CurrentOperation::None; // 接收启动失败，终止流程
-			}
+	switch (command) {
+	case CMD_SET_LED_CONTROL:
+		_shadow.IsLEDKnown = payload.size() == _shadow.LEDPayload.size();
+		if (_shadow.IsLEDKnown) {
+			std::copy(payload.begin(), payload.end(), _shadow.LEDPayload.begin());
 		}
+		_shadow.Sleep = SleepState::Awake;
+		break;
+	case CMD_ENTER_SLEEP_MODE:
+		_shadow.Sleep = (!payload.empty() && payload[0] == 0x01) ? SleepState::DeepSleeping : SleepState::Sleeping;
+		if (_shadow.IsLEDKnown && _shadow.LEDPayload[0] != static_cast<uint8_t>(LEDControl::Mode::Off)) {
+			// 休眠时 LED 的实际状态不确定，只保留已关灯的记录
+			_shadow.IsLEDKnown = false;
+		}
+		break;
+	case CMD_MATCH_SYNC:
+	case CMD_MATCH_ASYNC:
+	case CMD_VERIFY:
+	case CMD_AUTO_ENROLL:
+		// 采集指纹时模块会自行控制 LED
+		_shadow.IsLEDKnown = false;
+		_shadow.Sleep = SleepState::Awake;
+		break;
+	case CMD_SET_SYSTEM_POLICY:
+		_shadow.IsPolicyKnown = false;
+		_shadow.Sleep = SleepState::Awake;
 		break;
-	}
-	case CurrentOperation::None:
 	default:
+		// 其他命令得到响应说明模块已唤醒
+		_shadow.Sleep = SleepState::Awake;
 		break;
 	}
 }
 
 /**
  * @brief 启动异步操作
- * @param command 命令码
- * @param payload 命令负载
+ * @param frame 完整命令帧
  * @param op 操作类型 (AsyncMatch 或 AsyncEnroll)
  * @return 操作状态
  * @details 执行流程:
  *          1. 检查当前是否有异步操作在进行
- *          2. 启动 UART DMA 接收
- *          3. 构造并发送命令包
+ *          2. 确保环形 DMA 接收已启动
+ *          3. 发送命令帧
  *          4. 立即返回，不等待响应
  *          响应将在 UART 中断回调中由 _handleAsyncResponse() 处理
  */
-FPM383C::Status FPM383C::_startAsyncOperation(uint16_t command, std::span<const uint8_t> payload, CurrentOperation op) {
+FPM383C::Status FPM383C::_startAsyncOperation(std::span<const uint8_t> frame, CurrentOperation op) {
 	if (_currentOperation != CurrentOperation::None) {
 		return Status::Busy;
 	}
+	if (!_ensureRxRunning()) {
+		return Status::ReceiveError;
+	}
+	_flushRx();
+	_inFlightCommand = frame_command(frame);
 	_currentOperation = op;
+	_armAsyncDeadline(op == CurrentOperation::AsyncMatch ? ASYNC_MATCH_TIMEOUT_MS : ASYNC_ENROLL_STEP_TIMEOUT_MS);
 
-	if (!_uartReceive()) {
+	const Status status = _uartTransmit(frame) ? Status::AsyncInProgress : Status::TransmitError;
+	if (status != Status::AsyncInProgress) {
 		_currentOperation = CurrentOperation::None;
-		return Status::ReceiveError;
 	}
+	_updateShadow(frame_command(frame), frame_payload(frame), status);
+	return status;
+}
 
-	size_t packetSize = _buildPacket(command, payload);
-	if (!_uartTransmit(packetSize)) {
-		_currentOperation = CurrentOperation::None;
-		return Status::TransmitError;
+/**
+ * @brief 向帧重组器输入一个字节
+ * @param byte 接收到的字节
+ * @return true 表示刚刚得到一个完整的帧
+ * @details 状态机: 帧头(8) -> 长度(2) -> 链路层校验和(1) -> 应用层数据(N)
+ *          校验和为取反加一，因此区段内所有字节 (含校验和) 之和为 0
+ *          任一校验失败或长度非法时丢弃已收字节，重新搜索帧头
+ *          完整帧加入队列后在下一个空闲槽位中继续接收，帧边界之后的字节不会丢失
+ */
+bool FPM383C::FrameAssembler::Feed(uint8_t byte) {
+	if (_slot == NO_SLOT && !_acquireSlot()) {
+		return false; // 所有槽位都在排队或被借出
 	}
+	std::array<uint8_t, RX_BUFFER_SIZE> &frame = _frames[_slot];
+
+	switch (_state) {
+	case State::Header:
+		if (byte == FRAME_HEADER[_index]) {
+			frame[_index++] = byte;
+			if (_index == FRAME_HEADER.size()) {
+				_state = State::Length;
+			}
+		} else {
+			// 帧头内没有重复的前缀，失配后只需检查当前字节是否为新的帧头起始
+			_index = 0;
+			if (byte == FRAME_HEADER[0]) {
+				frame[_index++] = byte;
+			}
+		}
+		return false;
 
-	return Status::AsyncInProgress;
+	case State::Length:
+		frame[_index++] = byte;
+		if (_index == 10) {
+			_appDataLen = std::get<0>(*FPM383CResponse::LinkHeaderLayout::Decode(std::span<const uint8_t>(frame).first(_index)));
+			_state = State::Checksum;
+		}
+		return false;
+
+	case State::Checksum:
+	{
+		frame[_index++] = byte;
+		const uint8_t headerSum = std::accumulate(frame.begin(), frame.begin() + _index, static_cast<uint8_t>(0));
+		if (headerSum != 0 || _appDataLen < APP_LAYER_MIN_LEN || _appDataLen > frame.size() - LINK_LAYER_HEADER_LEN) {
+			_restart();
+			return false;
+		}
+		_sum = 0;
+		_state = State::AppData;
+		return false;
+	}
+
+	case State::AppData:
+	default:
+		frame[_index++] = byte;
+		_sum += byte;
+		if (_index < LINK_LAYER_HEADER_LEN + _appDataLen) {
+			return false;
+		}
+		if (_sum != 0) {
+			_restart();
+			return false;
+		}
+		// 完整帧入队，下一个字节到达时再选择写入槽位
+		_frameLengths[_slot] = _index;
+		_isQueued[_slot] = true;
+		_readyQueue[(_readyHead + _readyCount) % RX_SLOT_COUNT] = _slot;
+		_readyCount++;
+		_slot = NO_SLOT;
+		_restart();
+		return true;
+	}
+}
+
+void FPM383C::FrameAssembler::Release() {
+	if (_readyCount == 0) {
+		return;
+	}
+	_isQueued[_readyQueue[_readyHead]] = false;
+	_readyHead = (_readyHead + 1) % RX_SLOT_COUNT;
+	_readyCount--;
+}
+
+void FPM383C::FrameAssembler::Reset() {
+	while (HasFrame()) {
+		Release();
+	}
+	_restart();
+}
+
+volatile bool *FPM383C::FrameAssembler::Lease() {
+	if (!HasFrame()) {
+		return nullptr;
+	}
+	volatile bool *pin = &_isLeased[_readyQueue[_readyHead]];
+	*pin = true;
+	Release();
+	return pin;
+}
+
+bool FPM383C::FrameAssembler::_acquireSlot() {
+	for (uint8_t slot = 0; slot < RX_SLOT_COUNT; slot++) {
+		if (!_isLeased[slot] && !_isQueued[slot]) {
+			_slot = slot;
+			return true;
+		}
+	}
+	return false;
 }
 
 /**
@@ -581,47 +2339,68 @@ FPM383C::Status FPM383C::_startAsyncOperation(uint16_t command, std::span<const
  *          校验和算法: 累加所有字节，取反加一 (~sum + 1)
  */
 size_t FPM383C::_buildPacket(uint16_t command, std::span<const uint8_t> payload) {
+	return _buildPacket(_txBuffer, command, payload);
+}
+
+/**
+ * @brief 在指定缓冲区中构造命令数据包
+ * @param buffer 目标缓冲区
+ * @param command 命令码
+ * @param payload 命令负载数据
+ * @return 构造的数据包总长度
+ */
+size_t FPM383C::_buildPacket(std::span<uint8_t> buffer, uint16_t command, std::span<const uint8_t> payload) {
+	std::copy(payload.begin(), payload.end(), buffer.begin() + FPM383CFrame::PREFIX_LEN);
+	return _sealPacket(buffer, command, payload.size());
+}
+
+/**
+ * @brief 围绕已就位的负载补全数据包 (链路层、密码、命令码和校验和)
+ * @param buffer 目标缓冲区，负载已位于 [PREFIX_LEN, PREFIX_LEN + payloadLen)
+ * @param command 命令码
+ * @param payloadLen 负载长度
+ * @return 构造的数据包总长度
+ * @details 模板下载时数据由 source 直接写入帧中的负载位置，省去一次拷贝
+ */
+size_t FPM383C::_sealPacket(std::span<uint8_t> buffer, uint16_t command, size_t payloadLen) {
 	// 计算应用层数据长度: 密码(4) + 命令(2) + 负载(N) + 校验和(1)
-	const uint16_t appDataLen = 4 + 2 + payload.size() + 1;
+	const uint16_t appDataLen = 4 + 2 + payloadLen + 1;
 
 	// 填充帧头 (8字节固定值)
-	std::copy(FRAME_HEADER.begin(), FRAME_HEADER.end(), _txBuffer.begin());
+	std::copy(FRAME_HEADER.begin(), FRAME_HEADER.end(), buffer.begin());
 
 	// 填充应用层数据长度 (big-endian)
-	_txBuffer[8] = static_cast<uint8_t>(appDataLen >> 8);
-	_txBuffer[9] = static_cast<uint8_t>(appDataLen & 0xFF);
+	buffer[8] = static_cast<uint8_t>(appDataLen >> 8);
+	buffer[9] = static_cast<uint8_t>(appDataLen & 0xFF);
 
 	// 计算并填充链路层校验和
-	_txBuffer[10] = _calculateChecksum({ _txBuffer.data(), 10 });
+	buffer[10] = _calculateChecksum({ buffer.data(), 10 });
 
 	// 填充应用层数据
 	size_t offset = 11;
 
 	// 通信密码 (big-endian, 4字节)
-	_txBuffer[offset++] = static_cast<uint8_t>(_password >> 24);
-	_txBuffer[offset++] = static_cast<uint8_t>(_password >> 16);
-	_txBuffer[offset++] = static_cast<uint8_t>(_password >> 8);
-	_txBuffer[offset++] = static_cast<uint8_t>(_password & 0xFF);
+	buffer[offset++] = static_cast<uint8_t>(_password >> 24);
+	buffer[offset++] = static_cast<uint8_t>(_password >> 16);
+	buffer[offset++] = static_cast<uint8_t>(_password >> 8);
+	buffer[offset++] = static_cast<uint8_t>(_password & 0xFF);
 
 	// 命令码 (big-endian, 2字节)
-	_txBuffer[offset++] = static_cast<uint8_t>(command >> 8);
-	_txBuffer[offset++] = static_cast<uint8_t>(command & 0xFF);
+	buffer[offset++] = static_cast<uint8_t>(command >> 8);
+	buffer[offset++] = static_cast<uint8_t>(command & 0xFF);
 
-	// 命令负载 (可选)
-	if (!payload.empty()) {
-		std::copy(payload.begin(), payload.end(), _txBuffer.begin() + offset);
-		offset += payload.size();
-	}
+	// 命令负载 (已在缓冲区中就位)
+	offset += payloadLen;
 
 	// 计算并填充应用层校验和
-	_txBuffer[offset] = _calculateChecksum({ _txBuffer.data() + 11, appDataLen - 1u });
+	buffer[offset] = _calculateChecksum({ buffer.data() + 11, appDataLen - 1u });
 	offset++;
 
 	// Only for Debugging: Print the constructed packet
 	// char debugStr[256];
 	// size_t debugLen = 0;
 	// for (size_t i = 0; i < offset; ++i) {
-	// 	debugLen += snprintf(debugStr + debugLen, sizeof(debugStr) - debugLen, "%02X ", _txBuffer[i]);
+	// 	debugLen += snprintf(debugStr + debugLen, sizeof(debugStr) - debugLen, "%02X ", buffer[i]);
 	// }
 	// debugStr[debugLen] = '\0'; // 结束字符串
 	// HAL_UART_Transmit(&huart1, reinterpret_cast<uint8_t *>(debugStr), static_cast<uint16_t>(debugLen), 100);
@@ -671,7 +2450,7 @@ bool FPM383C::_parsePacket(std::span<const uint8_t> rxData, uint16_t &ackCommand
 	if (headerChecksum != rxData[10]) return false;
 
 	// 4. 提取应用层数据长度 (big-endian)
-	const uint16_t appDataLen = (static_cast<uint16_t>(rxData[8]) << 8) | static_cast<uint16_t>(rxData[9]);
+	const uint16_t appDataLen = std::get<0>(*FPM383CResponse::LinkHeaderLayout::Decode(rxData));
 	if (rxData.size() < static_cast<size_t>(LINK_LAYER_HEADER_LEN + appDataLen)) return false;
 
 	// 5. 获取应用层数据
@@ -681,22 +2460,15 @@ bool FPM383C::_parsePacket(std::span<const uint8_t> rxData, uint16_t &ackCommand
 	const uint8_t appChecksum = _calculateChecksum({ appData.data(), appData.size() - 1u });
 	if (appChecksum != appData.back()) return false;
 
-	// 7. 检查应用层最小长度: 密码(4) + 命令(2) + 错误码(4) = 10字节 (不含校验和)
-	if (appData.size() < 10) return false;
-
-	// 8. 提取命令码 (big-endian)
-	ackCommand = (static_cast<uint16_t>(appData[4]) << 8) | static_cast<uint16_t>(appData[5]);
+	// 7. 解析应用层头: 密码(4) + 命令(2, big-endian) + 错误码(4, big-endian) = 10字节 (不含校验和)
+	using HeaderLayout = FPM383CResponse::AppHeaderLayout;
+	const auto header = HeaderLayout::Decode(appData);
+	if (!header) return false;
+	ackCommand = std::get<0>(*header);
+	errorCode = static_cast<ModuleErrorCode>(std::get<1>(*header));
 
-	// 9. 提取错误码 (big-endian, 4字节)
-	errorCode = static_cast<ModuleErrorCode>(
-		(static_cast<uint32_t>(appData[6]) << 24) |
-		(static_cast<uint32_t>(appData[7]) << 16) |
-		(static_cast<uint32_t>(appData[8]) << 8) |
-		(static_cast<uint32_t>(appData[9]))
-		);
-
-	// 10. 提取响应负载 (如果有)
-	size_t payloadOffset = 10;
+	// 8. 提取响应负载 (如果有)
+	constexpr size_t payloadOffset = HeaderLayout::MIN_SIZE;
 	if (appData.size() > payloadOffset + 1) { // +1 是因为最后一字节是校验和
 		// 响应负载长度 = 应用层数据长度 - (密码4 + 命令2 + 错误码4 + 校验和1)
 		responsePayload = { const_cast<uint8_t *>(appData.data() + payloadOffset), appData.size() - payloadOffset - 1 };
@@ -705,4 +2477,48 @@ bool FPM383C::_parsePacket(std::span<const uint8_t> rxData, uint16_t &ackCommand
 	}
 
 	return true;
+}
+
+/**
+ * @brief 解码匹配结果负载 (同步匹配、1:1 比对与异步匹配共用)
+ * @details 异步匹配的结果直接由 CMD_MATCH_ASYNC (0x0121) 的应答携带，在接收回调中解码，不发送查询匹配结果命令
+ * @details 布局见 FPM383CResponse::MatchLayout，匹配失败时不写入分数和 ID
+ */
+bool FPM383C::_decodeMatch(std::span<const uint8_t> payload, MatchResult &result) {
+	const auto fields = FPM383CResponse::MatchLayout::Decode(payload);
+	if (!fields) {
+		return false;
+	}
+	const auto [flag, score, fingerId] = *fields;
+	result.IsSuccess = (flag == 1);
+	if (result.IsSuccess) {
+		result.MatchScore = score;
+		result.FingerId = fingerId;
+	}
+	return true;
+}
+
+/**
+ * @brief 解码自动注册进度负载 (同步与异步注册共用)
+ * @details 布局见 FPM383CResponse::EnrollProgressLayout，Step=0xFF 表示注册完成
+ */
+bool FPM383C::_decodeEnrollProgress(std::span<const uint8_t> payload, EnrollStatus &status) {
+	const auto fields = FPM383CResponse::EnrollProgressLayout::Decode(payload);
+	if (!fields) {
+		return false;
+	}
+	std::tie(status.Step, status.FingerId, status.Progress) = *fields;
+	status.IsComplete = (status.Step == 0xFF);
+	return true;
+}
+
+/**
+ * @brief 以绝对符号导出收发缓冲区大小，供构建后的 RAM 报告读取 (cmake/fpm383c-ram-report.cmake)
+ * @details 符号只存在于 ELF 符号表中，不占用 Flash 和 RAM；函数本身不会被调用，链接时被 --gc-sections 丢弃
+ */
+void FPM383C::_exportBufferSizes() {
+	asm(".global fpm383c_rx_buffer_bytes\n\t.set fpm383c_rx_buffer_bytes, %c0\n\t"
+		".global fpm383c_tx_buffer_bytes\n\t.set fpm383c_tx_buffer_bytes, %c1\n\t"
+		".global fpm383c_buffer_saving_bytes\n\t.set fpm383c_buffer_saving_bytes, %c2"
+		:: "i"(RX_SLOT_COUNT * RX_BUFFER_SIZE), "i"(TX_BUFFER_SIZE), "i"(BUFFER_RAM_SAVING_BYTES));
 }
\ No newline at end of file
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <coroutine>
 #include <cstdint>
-#include <functional>
 #include <numeric>
 #include <span>
 #include <utility> // For std::pair
 
+#include "Delegate.h"
+#include "FPM383CCommandSet.h"
+#include "FPM383CFrame.h"
+#include "FPM383CResponse.h"
+#include "RttEstimator.h"
+
 // --- 平台抽象层 ---
 // 该驱动支持 STM32 HAL 和 ESP32 ESP-IDF 两种平台
 // 通过条件编译实现跨平台兼容
@@ -28,6 +35,8 @@ using UartHandle_t = UART_HandleTypeDef *;
 #include "driver/uart.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/timers.h"
+#include "esp_cpu.h"
 
 using UartHandle_t = uart_port_t;
 
@@ -58,7 +67,9 @@ public:
 		ReceiveError,      // 接收失败
 		Busy,              // 设备正忙于另一项操作
 		AsyncInProgress,   // 异步操作已成功启动
-		UnknownError       // 未知错误
+		UnknownError,      // 未知错误
+		Aborted,           // 操作被调用方中止 (如模板传输中 sink/source 返回失败)
+		Unsupported        // 命令不在编译期选定的命令集中 (见 FPM383CCommandSet.h)
 	};
 
 	/**
@@ -103,6 +114,8 @@ public:
 		bool IsSuccess = false;      // 是否成功匹配
 		uint16_t FingerId = 0xFFFF;  // 匹配到的指纹 ID
 		uint16_t MatchScore = 0;     // 匹配分数
+		ModuleErrorCode ErrorCode = ModuleErrorCode::None;  // 模块返回的错误码 (异步匹配时用于区分未匹配和模块错误)
+		Status OperationStatus = Status::OK;                 // 异步匹配的完成状态，截止时间到达时为 Timeout
 	};
 
 	// 自动注册过程中的状态
@@ -112,8 +125,13 @@ public:
 		uint8_t Progress = 0;                               // 注册进度
 		uint16_t FingerId = 0xFFFF;                         // 最终分配/使用的指纹 ID
 		ModuleErrorCode ErrorCode = ModuleErrorCode::None;  // 注册过程中的错误码
+		Status OperationStatus = Status::OK;                // 异步注册的完成状态，截止时间到达时为 Timeout
 	};
 
+	// 回调类型，异步回调在调用 DispatchCompletions() 的任务中执行，捕获不得超过 CAPACITY 字节
+	using MatchCallback = Delegate<void(const MatchResult &)>;
+	using EnrollCallback = Delegate<void(const EnrollStatus &)>;
+
 	/**
 	 * @brief 系统策略配置
 	 * @details Bit1: 重复指纹检查, Bit2: 自学习功能, Bit4: 360度识别
@@ -209,6 +227,177 @@ public:
 	 */
 	using CommandResult = std::pair<Status, ModuleErrorCode>;
 
+	/**
+	 * @brief 批处理中的单条命令
+	 * @details 通过静态工厂函数构造，负载最多 5 字节
+	 */
+	struct BatchCommand {
+		uint16_t Command = 0;
+		uint8_t PayloadLength = 0;
+		std::array<uint8_t, 5> Payload{};
+
+		// 设置 LED 控制信息
+		static inline BatchCommand SetLEDControl(const LEDControl::ControlInfo &controlInfo) {
+			const auto &rawParams = controlInfo.GetRawParams();
+			return { CMD_SET_LED_CONTROL, 5, {
+				static_cast<uint8_t>(controlInfo.ControlMode),
+				static_cast<uint8_t>(controlInfo.LightColor),
+				rawParams[0], rawParams[1], rawParams[2]
+			} };
+		}
+
+		// 进入休眠模式
+		static inline constexpr BatchCommand EnterSleepMode(bool isDeepSleep = false) {
+			return { CMD_ENTER_SLEEP_MODE, 1, { static_cast<uint8_t>(isDeepSleep ? 0x01 : 0x00) } };
+		}
+
+		// 心跳
+		static inline constexpr BatchCommand Heartbeat() {
+			return { CMD_HEARTBEAT, 0, {} };
+		}
+
+		// 更新指纹特征值 (自学习)
+		static inline constexpr BatchCommand UpdateFeature(uint16_t fingerId) {
+			return { CMD_UPDATE_FEATURE, 2, { static_cast<uint8_t>(fingerId >> 8), static_cast<uint8_t>(fingerId & 0xFF) } };
+		}
+
+		// 删除指定 ID 的指纹
+		static inline constexpr BatchCommand DeleteFingerprint(uint16_t fingerId) {
+			return { CMD_DELETE_FINGER, 5, { 0x00, static_cast<uint8_t>(fingerId >> 8), static_cast<uint8_t>(fingerId & 0xFF), 0x00, 0x00 } };
+		}
+	};
+
+	/**
+	 * @brief 批处理的汇总结果
+	 */
+	struct BatchResult {
+		CommandResult Result = { Status::OK, ModuleErrorCode::None }; // 第一条失败命令的结果，全部成功时为 OK
+		uint8_t CompletedCount = 0;  // 已得到响应的命令数量
+		uint8_t FailedIndex = 0xFF;  // 第一条失败命令的索引，0xFF 表示全部成功
+	};
+
+	// 异步批处理完成回调，在调用 DispatchCompletions() 的任务中执行
+	using BatchCallback = Delegate<void(const BatchResult &)>;
+
+	/**
+	 * @brief 模板上传 (模块 -> 主机) 的数据接收方
+	 * @details 参数为 {本块在模板中的偏移, 本块数据}，返回 false 中止传输
+	 *          在调用任务中执行，执行期间下一块已在传输中
+	 */
+	using TemplateSink = Delegate<bool(uint16_t offset, std::span<const uint8_t> data)>;
+
+	/**
+	 * @brief 模板下载 (主机 -> 模块) 的数据提供方
+	 * @details 参数为 {本块在模板中的偏移, 待填充的缓冲区}，返回写入的字节数，不足缓冲区大小时中止传输
+	 *          在调用任务中执行，执行期间上一块已在传输中
+	 */
+	using TemplateSource = Delegate<size_t(uint16_t offset, std::span<uint8_t> buffer)>;
+
+	/**
+	 * @brief 响应租约: 固定接收槽位中的一个完整响应帧，租约释放前该槽位不会被之后的命令覆盖
+	 * @details - 帧重组器有 RX_SLOT_COUNT 个槽位，借出一个槽位后在其余槽位中继续接收，负载可以原地解码而无需拷贝
+	 *          - 所有槽位都在排队或被借出时新到达的帧被丢弃 (命令随之超时)，因此租约应在处理完毕后尽快释放
+	 *          - 只能移动，不能复制；析构时自动释放，释放只清除一个标志，可在任意任务中进行
+	 */
+	class ResponseLease {
+	public:
+		ResponseLease() = default;
+		ResponseLease(const ResponseLease &) = delete;
+		ResponseLease &operator=(const ResponseLease &) = delete;
+
+		ResponseLease(ResponseLease &&other) noexcept
+			: _pin(std::exchange(other._pin, nullptr)), _payload(std::exchange(other._payload, {})) { }
+
+		ResponseLease &operator=(ResponseLease &&other) noexcept {
+			if (this != &other) {
+				Release();
+				_pin = std::exchange(other._pin, nullptr);
+				_payload = std::exchange(other._payload, {});
+			}
+			return *this;
+		}
+
+		~ResponseLease() { Release(); }
+
+		// 释放槽位，之后 Payload() 为空
+		inline void Release() {
+			if (_pin != nullptr) {
+				*_pin = false;
+				_pin = nullptr;
+			}
+			_payload = {};
+		}
+
+		// 是否持有一个响应帧
+		inline explicit operator bool() const { return _pin != nullptr; }
+
+		// 响应负载 (不含应用层头和校验和)，租约有效期间保持不变
+		inline std::span<const uint8_t> Payload() const { return _payload; }
+
+	private:
+		friend class FPM383C;
+		ResponseLease(volatile bool *pin, std::span<const uint8_t> payload) : _pin(pin), _payload(payload) { }
+
+		volatile bool *_pin = nullptr;      // 槽位占用标志
+		std::span<const uint8_t> _payload;  // 指向槽位中的响应负载
+	};
+
+	/**
+	 * @brief 状态影子统计
+	 */
+	struct ShadowStats {
+		uint32_t ElidedCommands = 0; // 因效果已生效而省略的命令数 (即节省的往返次数)
+		uint32_t Invalidations = 0;  // 因通信错误导致影子状态全部失效的次数
+	};
+
+	/**
+	 * @brief 链路恢复级别，按代价从低到高逐级升级
+	 */
+	enum class RecoveryLevel : uint8_t {
+		None,        // 链路正常，无需恢复
+		FlushRx,     // 丢弃接收残留后以心跳确认
+		Resync,      // 重新初始化 UART 后以心跳重新同步，依次尝试当前、协商目标和出厂波特率
+		PowerCycle,  // 通过电源引脚重启模块，上电后以心跳探测就绪 (仅在构造时给出电源引脚时可用)
+		Failed       // 所有级别均失败，链路仍然中断
+	};
+
+	// 异步恢复完成回调，参数为恢复链路的级别 (全部失败时为 Failed)，在调用 DispatchCompletions() 的任务中执行
+	using RecoveryCallback = Delegate<void(RecoveryLevel)>;
+
+	/**
+	 * @brief 链路恢复统计
+	 */
+	struct RecoveryStats {
+		std::array<uint32_t, 3> Recoveries{}; // 各级别 (FlushRx、Resync、PowerCycle) 恢复成功的次数
+		uint32_t Failures = 0;                // 所有级别均失败的次数
+		uint32_t LastOutageMs = 0;            // 最近一次从检测到中断到恢复的时间
+		uint32_t MaxOutageMs = 0;             // 最长的一次中断时间
+	};
+
+	/**
+	 * @brief 接收中断耗时统计 (CPU 周期，STM32 上由 DWT 周期计数器测量，ESP32 上为接收事件任务的耗时)
+	 * @details 异步结果的回调在 DispatchCompletions() 中执行，接收中断只校验、解码并写入完成记录；
+	 *          MaxRxIsrCycles + MaxDispatchCycles 即回调仍在中断中执行时的最坏耗时
+	 */
+	struct IsrStats {
+		uint32_t MaxRxIsrCycles = 0;        // 接收回调 (UartRxCallback) 的最长耗时
+		uint32_t LastRxIsrCycles = 0;       // 最近一次接收回调的耗时
+		uint32_t MaxDispatchCycles = 0;     // 单条完成记录分发 (即应用回调) 的最长耗时
+		uint32_t DispatchedCompletions = 0; // 已分发的完成记录数
+		uint32_t DroppedCompletions = 0;    // 完成队列已满而丢弃的记录数
+	};
+
+	static constexpr size_t COMPLETION_QUEUE_LENGTH = 4; // 完成队列长度 (2 的幂)，异步注册每次按压产生一条进度记录
+
+	// --- 链路恢复参数 ---
+	static constexpr uint32_t RECOVERY_PROBE_TIMEOUT_MS = 100;       // 恢复时每次心跳的超时
+	static constexpr uint32_t POWER_OFF_MS = 20;                     // 断电保持时间，保证模块复位
+	static constexpr uint32_t POWER_UP_TIMEOUT_MS = 500;             // 上电后持续探测模块就绪的最长时间
+	static constexpr uint32_t RECOVERY_ESCALATION_WINDOW_MS = 5000;  // 恢复后在此时间内再次中断时直接升级
+	// 单次恢复的最长耗时 (不计发送时间): FlushRx 1 次心跳 + Resync 3 次 + PowerCycle 断电后在上电窗口内持续探测
+	// (窗口结束前发出的最后一次心跳再等待一次超时)；没有电源引脚时不执行 PowerCycle，最长为 RECOVERY_PROBE_TIMEOUT_MS * 4
+	static constexpr uint32_t MAX_RECOVERY_TIME_MS = RECOVERY_PROBE_TIMEOUT_MS * 5 + POWER_OFF_MS + POWER_UP_TIMEOUT_MS;
+
 	/**
 	 * @brief 构造函数
 	 * @param huart UART 句柄
@@ -219,10 +408,57 @@ public:
 		: _huart(huart), _touchPin(touchPin), _powerPin(powerPin) { }
 
 	/**
-	 * @brief 初始化模块
-	 * @return 操作状态和模块错误码
+	 * @brief 初始化模块，可选协商更高的波特率
+	 * @details 执行流程:
+	 *          1. 若给出 knownBaudRate / targetBaudRate，先以这两个波特率发送心跳，失败时回退到默认波特率 (57600)
+	 *          2. 若给出 targetBaudRate，请求模块切换波特率，主机随后重新配置 UART 并以心跳验证
+	 *          3. 验证失败时切回原波特率，仍失败时再以目标波特率验证；之后的链路恢复同样会探测目标波特率
+	 *          最终使用的波特率可通过 GetBaudRate() 获取，由调用方决定是否持久化
+	 * @param targetBaudRate 希望切换到的波特率，0 表示不协商
+	 * @param knownBaudRate 上次协商成功并保存的波特率，0 表示未知
+	 * @return 操作状态和模块错误码 (协商失败但回退成功时仍为 OK)
+	 */
+	CommandResult Init(uint32_t targetBaudRate = 0, uint32_t knownBaudRate = 0);
+
+	/**
+	 * @brief 链路是否被判定为中断
+	 * @details 超时、无效响应、收发失败、UART 错误和放弃异步操作都会将链路标记为中断，直到 Recover() 确认恢复
 	 */
-	CommandResult Init();
+	inline bool IsLinkDown() const { return _isLinkDown; }
+
+	/**
+	 * @brief 恢复中断的链路
+	 * @details 从 FlushRx 开始逐级升级，每一级都以心跳确认；上一次恢复后 RECOVERY_ESCALATION_WINDOW_MS 内再次中断时，
+	 *          从上一次成功级别的下一级开始。没有电源引脚时最高只到 Resync
+	 *          单次调用最长耗时 MAX_RECOVERY_TIME_MS，会放弃正在进行的异步操作，必须在驱动所有者任务中调用
+	 * @return 恢复链路的级别，链路正常时为 None，全部失败时为 Failed (链路仍为中断，可稍后再次调用)；
+	 *         批处理、取消或异步恢复进行中时同样返回 Failed，不计入统计
+	 */
+	RecoveryLevel Recover();
+
+	/**
+	 * @brief 开始异步恢复中断的链路
+	 * @details 级别和探测顺序与 Recover() 相同，但每次心跳都以异步批处理发出，断电保持由截止时间定时器计时，
+	 *          探测之间的推进在 DispatchCompletions() 中进行，调用任务不阻塞；结果交给恢复回调
+	 *          恢复期间其他命令返回 Busy
+	 * @return AsyncInProgress 表示已开始，OK 表示链路正常 (不调用回调)，Busy 表示有批处理或取消在进行
+	 */
+	Status StartRecovery();
+
+	/**
+	 * @brief 获取链路恢复统计 (含最长中断时间)
+	 */
+	inline const RecoveryStats &GetRecoveryStats() const { return _recoveryStats; }
+
+	/**
+	 * @brief 获取当前链路使用的波特率
+	 */
+	inline uint32_t GetBaudRate() const { return _baudRate; }
+
+	/**
+	 * @brief 获取模块使用的 UART
+	 */
+	inline UartHandle_t GetUartHandle() const { return _huart; }
 
 	/**
 	 * @brief 检查手指是否按在传感器上
@@ -231,6 +467,17 @@ public:
 	 */
 	CommandResult IsFingerPressed(bool &isPressed);
 
+	/**
+	 * @brief 1:1 同步比对: 只与指定 ID 的模板比对，耗时与指纹库大小无关
+	 * @details 用于已知身份的开门 (如密码、卡片或远程请求给出了指纹 ID)；
+	 *          模块返回的 ID 与 fingerId 不一致时按比对失败处理；
+	 *          1:1 比对命令未经实物验证，模块以 CmdInvalid 拒绝时记为不支持，本次及之后的比对以 1:N 匹配代替 (结果可能是其他已注册的 ID)
+	 * @param fingerId 要比对的指纹 ID
+	 * @param result [out] 比对结果，格式与 1:N 匹配相同
+	 * @return 操作状态和模块错误码
+	 */
+	CommandResult Verify(uint16_t fingerId, MatchResult &result);
+
 	/**
 	 * @brief 1:N 同步匹配指纹
 	 * @param result [out] 匹配结果
@@ -247,7 +494,7 @@ public:
 	 * @return 操作状态和模块错误码
 	 */
 	CommandResult AutoEnroll(EnrollStatus &finalStatus, uint16_t fingerId = 0xFF, uint8_t requiredPresses = 6,
-		const std::function<void(const EnrollStatus &)> &progressCallback = nullptr);
+		const EnrollCallback &progressCallback = nullptr);
 
 	/**
 	 * @brief 删除指定 ID 的指纹
@@ -269,11 +516,22 @@ public:
 	 */
 	CommandResult GetFingerprintCount(uint16_t &count);
 
+	/**
+	 * @brief 获取指纹 ID 占用位图
+	 * @details 位图按 ID 升序排列，第 n 个字节的第 k 位 (LSB 为第 0 位) 对应 ID 8n+k
+	 *
+	 *          该命令码未在实物模块上验证，首次调用以短超时探测: 超时或模块报告命令码无效时
+	 *          记为不支持并返回 Unsupported，不判定链路中断，之后的调用直接返回 Unsupported
+	 * @param bitmap [out] 位图缓冲区，模块返回的位图超出部分被丢弃，不足部分清零
+	 * @return 操作状态和模块错误码
+	 */
+	CommandResult GetIdBitmap(std::span<uint8_t> bitmap);
+
 	/**
 	 * @brief 设置模块通信密码
 	 * @param password 新密码
 	 * @param writeToFlash 是否写入 Flash
-	 * @return 操作状态和模块错误码
+	 * @return 操作状态和模块错误码，命令集不含修改密码时为 Unsupported
 	 */
 	CommandResult SetPassword(uint32_t password, bool writeToFlash = true);
 
@@ -285,6 +543,34 @@ public:
 	 */
 	CommandResult UpdateFeatureAfterMatch(uint16_t fingerId);
 
+	/**
+	 * @brief 推迟自学习，等模块空闲时再由 RunDeferredFeatureUpdate() 执行
+	 * @details 自学习使用模块中最近一次匹配的特征，因此只保留最新的一个 ID (同一 ID 自然合并)；
+	 *          在执行前发出新的匹配、注册或休眠命令时，特征被覆盖，待执行的自学习自动取消
+	 * @param fingerId 刚刚匹配成功的指纹 ID
+	 */
+	inline void DeferFeatureUpdate(uint16_t fingerId) { _deferredFeatureUpdateId = fingerId; }
+
+	/**
+	 * @brief 是否有待执行的自学习
+	 */
+	inline bool HasDeferredFeatureUpdate() const { return _deferredFeatureUpdateId != NO_DEFERRED_FEATURE_UPDATE; }
+
+	/**
+	 * @brief 执行待执行的自学习 (模块写 Flash，较耗时)
+	 * @param fingerId [out] 执行自学习的指纹 ID
+	 * @return 操作状态和模块错误码，没有待执行的自学习时返回 OK 且 fingerId 为 0xFFFF
+	 */
+	CommandResult RunDeferredFeatureUpdate(uint16_t &fingerId);
+
+	/**
+	 * @brief 以异步批处理开始待执行的自学习，结果交给批处理回调
+	 * @param fingerId [out] 执行自学习的指纹 ID
+	 * @return AsyncInProgress 表示已开始，没有待执行的自学习时返回 OK 且 fingerId 为 0xFFFF，
+	 *         驱动忙时为 Busy (自学习仍保留)
+	 */
+	Status StartDeferredFeatureUpdate(uint16_t &fingerId);
+
 	/**
 	 * @brief 获取系统策略
 	 * @return 返回一个包含操作结果和策略设置的 pair
@@ -298,6 +584,27 @@ public:
 	//  */
 	// CommandResult SetSystemPolicy(const SystemPolicy &policy);
 
+	/**
+	 * @brief 分块上传指定 ID 的指纹模板 (模块 -> 主机)
+	 * @details 双缓冲流水线: 收到第 N 块后立即请求第 N+1 块，在模块准备和传输第 N+1 块期间把第 N 块交给 sink，
+	 *          sink 直接读取接收槽位中的数据 (响应租约)，整个模板不需要在 RAM 中缓存或拷贝
+	 * @param fingerId 指纹 ID
+	 * @param sink 数据接收方
+	 * @param templateSize [out] 模板总字节数，在第一次调用 sink 之前写入
+	 * @return 操作状态和模块错误码，sink 返回 false 时为 Aborted，命令集不含模板传输时为 Unsupported
+	 */
+	CommandResult UploadTemplate(uint16_t fingerId, const TemplateSink &sink, uint16_t &templateSize);
+
+	/**
+	 * @brief 分块下载指纹模板到指定 ID (主机 -> 模块)
+	 * @details 双缓冲流水线: 第 N 块在发送和等待确认期间，由 source 在另一半发送缓冲区中准备第 N+1 块
+	 * @param fingerId 要写入的指纹 ID
+	 * @param templateSize 模板总字节数
+	 * @param source 数据提供方
+	 * @return 操作状态和模块错误码，source 提供的数据不足时为 Aborted，命令集不含模板传输时为 Unsupported
+	 */
+	CommandResult DownloadTemplate(uint16_t fingerId, uint16_t templateSize, const TemplateSource &source);
+
 	/**
 	 * @brief 让模块进入休眠模式以节省功耗
 	 * @param isDeepSleep 是否进入深度休眠模式（默认为普通休眠）
@@ -313,108 +620,800 @@ public:
 	CommandResult SetLEDControl(const LEDControl::ControlInfo &controlInfo);
 
 
+	/**
+	 * @brief 批量执行多条命令
+	 * @details 命令在驱动内部背靠背执行: 下一条命令直接在接收完成回调中发出，
+	 *          调用任务只在整批完成 (或失败中止) 后被唤醒一次
+	 * @param commands 要执行的命令列表 (在返回前必须保持有效)
+	 * @param abortOnFailure 遇到第一条失败的命令时是否中止后续命令
+	 * @return 汇总结果
+	 */
+	BatchResult RunBatch(std::span<const BatchCommand> commands, bool abortOnFailure = true);
+
+	/**
+	 * @brief 异步批量执行多条命令
+	 * @details 与 RunBatch() 相同地在接收回调中背靠背执行，发出第一条命令后立即返回，汇总结果由 DispatchCompletions()
+	 *          交给批处理回调；截止时间为各命令超时之和，到达时以 Timeout 结束
+	 * @param commands 要执行的命令列表 (在回调之前必须保持有效)
+	 * @param abortOnFailure 遇到第一条失败的命令时是否中止后续命令
+	 * @return AsyncInProgress 表示已开始 (所有命令均被省略时同样在下一次分发时回调)，Busy 表示驱动忙
+	 */
+	Status StartAsyncBatch(std::span<const BatchCommand> commands, bool abortOnFailure = true);
+
+	/**
+	 * @brief 发送任意命令，以租约的形式返回响应
+	 * @details 用于驱动尚未封装的命令或较大的响应 (如状态转储)，调用方可以在租约有效期间原地解码负载，
+	 *          期间之后的命令不会覆盖该响应
+	 *          收发缓冲区按编译期命令集中最大的帧分配，超过 RX_BUFFER_SIZE 的响应帧会被丢弃 (表现为超时)，
+	 *          需要更大的响应时应把命令加入 FPM383CCommandSet.h 中的命令集
+	 * @param command 命令码
+	 * @param payload 命令负载
+	 * @param response [out] 响应租约，模块返回错误码时同样持有该响应
+	 * @param timeout 超时时间 (毫秒)
+	 * @return 操作状态和模块错误码，负载超出发送缓冲区时为 TransmitError
+	 */
+	CommandResult SendCommand(uint16_t command, std::span<const uint8_t> payload, ResponseLease &response, uint32_t timeout = DEFAULT_TIMEOUT_MS);
+
+
 	// --- 异步方法 ---
+	// 异步操作的截止时间由软件定时器监督 (FreeRTOS)，到期时驱动中止接收、以 Timeout 完成操作并释放驱动，
+	// 不需要任何任务轮询；异步注册的截止时间从最近一次进度应答起算
+	static constexpr uint32_t ASYNC_MATCH_TIMEOUT_MS = 3000;         // 异步匹配的截止时间
+	static constexpr uint32_t ASYNC_ENROLL_STEP_TIMEOUT_MS = 15000;  // 异步注册每一步的截止时间
+
 	/**
 	 * @brief 开始异步匹配 (1:N)
-	 * @details 发送匹配命令后立即返回，结果通过回调函数通知
-	 * @return OK 表示命令已发送，Busy 表示已有异步操作在进行
+	 * @details 发送匹配命令后立即返回，结果由 DispatchCompletions() 交给匹配回调
+	 * @param preemptEnroll 为 true 时先取消进行中的异步注册，门口的用户不必等待注册流程结束；
+	 *                      不等待取消应答，匹配命令在取消应答到达时由接收回调发出；模块拒绝取消时注册继续，匹配以 Busy 回调；
+	 *                      模块不支持取消或取消命令未能发出时不抢占，返回 Busy
+	 * @return AsyncInProgress 表示命令已发送 (或取消命令已发送)，Busy 表示已有异步操作在进行
+	 */
+	Status StartAsyncMatch(bool preemptEnroll = false);
+
+	/**
+	 * @brief 开始异步 1:1 比对
+	 * @details 与 StartAsyncMatch() 相同，只与指定 ID 的模板比对；模块返回的 ID 与 fingerId 不一致时按比对失败回调；
+	 *          模块不支持 1:1 比对时 (见 Verify()) 接收回调直接改发 1:N 匹配，回调得到的是匹配结果
+	 * @param fingerId 要比对的指纹 ID
+	 * @param preemptEnroll 见 StartAsyncMatch()
 	 */
-	Status StartAsyncMatch();
+	Status StartAsyncVerify(uint16_t fingerId, bool preemptEnroll = false);
 
 	/**
 	 * @brief 开始异步注册
-	 * @details 发送注册命令后立即返回，进度和最终结果通过回调函数通知
+	 * @details 发送注册命令后立即返回，进度和最终结果由 DispatchCompletions() 交给注册回调
 	 * @param fingerId 要注册的指纹 ID
 	 * @param requiredPresses 需要按下的次数
 	 * @return OK 表示命令已发送，Busy 表示已有异步操作在进行
 	 */
 	Status StartAsyncEnroll(uint16_t fingerId = 0xFFFF, uint8_t requiredPresses = 6);
 
+	/**
+	 * @brief 放弃进行中的异步匹配或注册
+	 * @details 不通知模块，只释放驱动，截止时间监督之外需要立即释放驱动时使用 (如链路恢复)；之后迟到的响应会被忽略。
+	 *          原操作以 Aborted 结果交给匹配回调或注册完成回调
+	 * @return 是否有异步操作被放弃
+	 */
+	bool AbandonAsyncOperation();
+
+	/**
+	 * @brief 取消进行中的异步匹配或注册
+	 * @details 向模块发送取消命令并阻塞等待取消命令本身的应答
+	 *          - 切换状态在临界区中完成，此后原操作迟到的进度、结果和 CmdAborted 应答由接收回调按命令码丢弃，不再调用回调
+	 *          - 超时之后才到达的取消应答同样按命令码丢弃，不会被当作下一条命令的响应
+	 *          - 模块确认取消或超时后，原操作以 Aborted 结果交给匹配回调或注册完成回调
+	 *          - 模块拒绝取消或取消命令未能发出时原操作继续
+	 *          - 没有异步操作时直接返回 OK，不与模块通信
+	 * @return 操作状态和模块错误码，超时时驱动同样被释放；模块不支持取消时为 Unsupported，取消命令未能发出时为 Busy
+	 */
+	CommandResult Cancel();
+
+
+	// --- 协程接口 ---
+	/**
+	 * @brief 协程恢复调度器
+	 * @details 在调用 DispatchCompletions() 的任务中被调用，例如将协程投递到执行器的就绪队列 (见 ScheduleOnCoExecutor)
+	 */
+	using ResumeScheduler = void (*)(std::coroutine_handle<>);
+
+	/**
+	 * @brief 设置协程恢复调度器，未设置时所有可等待操作立即以 UnknownError 返回
+	 */
+	inline void SetResumeScheduler(ResumeScheduler scheduler) { _resumeScheduler = scheduler; }
+
+	// 可等待对象都在所有者任务的协程中使用 (见 FPM383CService::Spawn())，操作的结果与回调一样经完成队列交付:
+	// 等待中的协程优先于回调，DispatchCompletions() 写入结果后交给恢复调度器；启动失败时不挂起，直接以失败状态继续执行
+
+	// co_await fpm383c.MatchAsync() / VerifyAsync() 的可等待对象，结果为 {状态, 匹配结果}
+	class MatchAwaiter {
+	public:
+		MatchAwaiter(FPM383C &driver, uint16_t fingerId, bool preemptEnroll)
+			: _driver(driver), _fingerId(fingerId), _preemptEnroll(preemptEnroll) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle);
+		std::pair<Status, MatchResult> await_resume() const { return { _result.OperationStatus, _result }; }
+	private:
+		FPM383C &_driver;
+		uint16_t _fingerId;
+		bool _preemptEnroll;
+		MatchResult _result;
+	};
+
+	// co_await fpm383c.AutoEnrollAsync() 的可等待对象，结果为 {状态, 最终注册状态}，模块返回错误码时状态为 ModuleError
+	class EnrollAwaiter {
+	public:
+		EnrollAwaiter(FPM383C &driver, uint16_t fingerId, uint8_t requiredPresses)
+			: _driver(driver), _fingerId(fingerId), _requiredPresses(requiredPresses) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle);
+		std::pair<Status, EnrollStatus> await_resume() const {
+			const bool isModuleError = _result.OperationStatus == Status::OK && _result.ErrorCode != ModuleErrorCode::None;
+			return { isModuleError ? Status::ModuleError : _result.OperationStatus, _result };
+		}
+	private:
+		FPM383C &_driver;
+		uint16_t _fingerId;
+		uint8_t _requiredPresses;
+		EnrollStatus _result;
+	};
+
+	// co_await fpm383c.BatchAsync() / CommandAsync() 的可等待对象，结果为批处理汇总结果
+	class BatchAwaiter {
+	public:
+		BatchAwaiter(FPM383C &driver, std::span<const BatchCommand> commands, bool abortOnFailure)
+			: _driver(driver), _commands(commands), _abortOnFailure(abortOnFailure) { }
+		BatchAwaiter(FPM383C &driver, const BatchCommand &command)
+			: _driver(driver), _single(command), _abortOnFailure(true) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle);
+		BatchResult await_resume() const { return _result; }
+	private:
+		FPM383C &_driver;
+		std::span<const BatchCommand> _commands; // 为空时执行 _single
+		BatchCommand _single;
+		bool _abortOnFailure;
+		BatchResult _result;
+	};
+
+	// co_await fpm383c.DeferredFeatureUpdateAsync() 的可等待对象，结果为 {指纹 ID, 自学习结果}，没有待执行的自学习时 ID 为 0xFFFF
+	class FeatureUpdateAwaiter {
+	public:
+		explicit FeatureUpdateAwaiter(FPM383C &driver) : _driver(driver) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle);
+		std::pair<uint16_t, CommandResult> await_resume() const { return { _fingerId, _result.Result }; }
+	private:
+		FPM383C &_driver;
+		uint16_t _fingerId = NO_DEFERRED_FEATURE_UPDATE;
+		BatchResult _result;
+	};
+
+	// co_await fpm383c.RecoverAsync() 的可等待对象，结果为 {状态, 恢复级别}
+	class RecoveryAwaiter {
+	public:
+		explicit RecoveryAwaiter(FPM383C &driver) : _driver(driver) { }
+		bool await_ready() const noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> handle);
+		std::pair<Status, RecoveryLevel> await_resume() const { return { _status, _level }; }
+	private:
+		FPM383C &_driver;
+		Status _status = Status::UnknownError;
+		RecoveryLevel _level = RecoveryLevel::None;
+	};
+
+	/**
+	 * @brief 可等待的 1:N 匹配
+	 * @details auto [status, result] = co_await fpm383c.MatchAsync();
+	 * @param preemptEnroll 见 StartAsyncMatch()
+	 */
+	inline MatchAwaiter MatchAsync(bool preemptEnroll = false) { return MatchAwaiter(*this, MATCH_ANY_ID, preemptEnroll); }
+
+	/**
+	 * @brief 可等待的 1:1 比对
+	 * @param fingerId 要比对的指纹 ID
+	 * @param preemptEnroll 见 StartAsyncMatch()
+	 */
+	inline MatchAwaiter VerifyAsync(uint16_t fingerId, bool preemptEnroll = false) { return MatchAwaiter(*this, fingerId, preemptEnroll); }
+
+	/**
+	 * @brief 可等待的自动注册，注册完成 (或出错、被取消) 后恢复，进度仍通过进度回调通知
+	 * @param fingerId 要注册的指纹 ID，0xFFFF 表示由模块分配
+	 * @param requiredPresses 需要按下的次数
+	 */
+	inline EnrollAwaiter AutoEnrollAsync(uint16_t fingerId = 0xFFFF, uint8_t requiredPresses = 6) {
+		return EnrollAwaiter(*this, fingerId, requiredPresses);
+	}
+
+	/**
+	 * @brief 可等待的批处理
+	 * @param commands 要执行的命令列表 (在恢复前必须保持有效)
+	 * @param abortOnFailure 遇到第一条失败的命令时是否中止后续命令
+	 */
+	inline BatchAwaiter BatchAsync(std::span<const BatchCommand> commands, bool abortOnFailure = true) {
+		return BatchAwaiter(*this, commands, abortOnFailure);
+	}
+
+	/**
+	 * @brief 可等待的单条简单命令 (如关灯、休眠、删除指纹)
+	 * @details auto result = co_await fpm383c.CommandAsync(FPM383C::BatchCommand::EnterSleepMode());
+	 */
+	inline BatchAwaiter CommandAsync(const BatchCommand &command) { return BatchAwaiter(*this, command); }
+
+	/**
+	 * @brief 可等待的推迟自学习 (见 StartDeferredFeatureUpdate())
+	 */
+	inline FeatureUpdateAwaiter DeferredFeatureUpdateAsync() { return FeatureUpdateAwaiter(*this); }
+
+	/**
+	 * @brief 可等待的链路恢复 (见 StartRecovery())，链路正常时不挂起，结果为 {OK, None}
+	 */
+	inline RecoveryAwaiter RecoverAsync() { return RecoveryAwaiter(*this); }
+
+
+	// --- 自适应超时 ---
+	/**
+	 * @brief 设置自适应超时的上下限
+	 * @details 短命令 (心跳、查询手指、LED、休眠等) 的超时由观测到的往返时间得出: SRTT + 4 * RTTVAR，
+	 *          并限制在 [floorMs, ceilingMs] 内；还没有样本时使用 ceilingMs
+	 *          匹配、注册、删除、写 Flash 等耗时不确定的命令仍使用各自固定的超时
+	 * @param floorMs 超时下限 (毫秒)
+	 * @param ceilingMs 超时上限 (毫秒)
+	 */
+	inline void SetAdaptiveTimeoutBounds(uint32_t floorMs, uint32_t ceilingMs) {
+		_timeoutFloorMs = floorMs;
+		_timeoutCeilingMs = std::max(floorMs, ceilingMs);
+	}
+
+
+	// --- 状态影子 ---
+	/**
+	 * @brief 获取冗余命令省略统计
+	 */
+	inline const ShadowStats &GetShadowStats() const { return _shadowStats; }
+
+	/**
+	 * @brief 使模块状态影子失效
+	 * @details 模块状态在驱动之外被改变 (如断电重启) 时调用，之后的 LED、休眠命令和策略查询都会真实发送
+	 */
+	void InvalidateShadow();
+
 
 	// --- 回调注册 ---
-	inline void RegisterMatchCallback(const std::function<void(const MatchResult &)> &callback) { _matchCallback = callback; }
-	inline void RegisterEnrollProgressCallback(const std::function<void(const EnrollStatus &)> &callback) { _enrollProgressCallback = callback; }
-	inline void RegisterEnrollCompleteCallback(const std::function<void(const EnrollStatus &)> &callback) { _enrollCompleteCallback = callback; }
+	inline void RegisterMatchCallback(const MatchCallback &callback) { _matchCallback = callback; }
+	inline void RegisterEnrollProgressCallback(const EnrollCallback &callback) { _enrollProgressCallback = callback; }
+	inline void RegisterEnrollCompleteCallback(const EnrollCallback &callback) { _enrollCompleteCallback = callback; }
+	inline void RegisterBatchCallback(const BatchCallback &callback) { _batchCallback = callback; }
+	inline void RegisterRecoveryCallback(const RecoveryCallback &callback) { _recoveryCallback = callback; }
+
+	/**
+	 * @brief 完成通知，完成记录入队后在接收回调 (ISR) 或截止时间定时器任务中调用
+	 * @details 必须是 ISR 安全的，通常用于唤醒调用 DispatchCompletions() 的任务
+	 */
+	using CompletionNotifier = Delegate<void()>;
+	inline void SetCompletionNotifier(const CompletionNotifier &notifier) { _completionNotifier = notifier; }
+
+	/**
+	 * @brief 按到达顺序分发完成队列中的异步结果，在任务 (无 RTOS 时为主循环) 中调用
+	 * @details 匹配、注册进度/完成、批处理和恢复回调都在此处执行，接收中断只校验帧并写入定长的完成记录，
+	 *          因此中断耗时有上界，与应用回调无关；异步恢复的下一次探测也在此处发出
+	 * @return 分发的记录数
+	 */
+	size_t DispatchCompletions();
+
+	/**
+	 * @brief 获取接收中断和完成分发的耗时统计
+	 */
+	inline const IsrStats &GetIsrStats() const { return _isrStats; }
 
 	/**
 	 * @brief UART 接收回调处理函数
 	 * @details 在 STM32 的 HAL_UARTEx_RxEventCallback 或 ESP-IDF 的 UART 事件任务中调用
-	 * @param size 接收到的数据长度
+	 *          STM32: 接收使用循环 DMA 环形缓冲区，HT/TC/IDLE 事件均会触发此回调
+	 * @param size STM32: DMA 在环形缓冲区中的写入位置; ESP-IDF: UART 驱动中新到达的字节数
 	 */
 	void UartRxCallback(uint16_t size);
 
+	/**
+	 * @brief UART 错误回调处理函数
+	 * @details 在 STM32 的 HAL_UART_ErrorCallback 中调用，HAL 出错后会停止 DMA 接收，此处重新启动环形接收
+	 */
+	void UartErrorCallback();
+
 private:
 	// --- 协议常量 ---
-	static constexpr std::array<uint8_t, 8> FRAME_HEADER = { 0xF1, 0x1F, 0xE2, 0x2E, 0xB6, 0x6B, 0xA8, 0x8A };
+	static constexpr std::array<uint8_t, 8> FRAME_HEADER = FPM383CFrame::HEADER;
 	static constexpr uint32_t DEFAULT_PASSWORD = 0x00000000;
 	static constexpr uint32_t DEFAULT_TIMEOUT_MS = 2000;
 	static constexpr uint32_t AUTO_ENROLL_TIMEOUT_MS = 15000; // 注册操作较耗时，需要更长超时
+	static constexpr uint32_t DEFAULT_BAUD_RATE = 57600;      // 模块出厂波特率，与 MX_USART2_UART_Init 一致
+	static constexpr uint32_t BAUD_PROBE_TIMEOUT_MS = 200;    // 探测波特率时心跳的超时时间
+	static constexpr uint32_t BAUD_SWITCH_DELAY_MS = 20;      // 模块应答后切换波特率所需的时间
+	static constexpr uint32_t ADAPTIVE_TIMEOUT = 0;           // 超时参数取此值时使用该命令学习到的超时
+	static constexpr uint32_t DEFAULT_TIMEOUT_FLOOR_MS = 20;  // 自适应超时的默认下限
+	static constexpr uint32_t CANCEL_TIMEOUT_MS = 500;        // 等待取消应答的超时时间
+	static constexpr uint32_t ID_BITMAP_PROBE_TIMEOUT_MS = 200; // 首次获取 ID 位图 (探测模块是否支持) 的超时时间
+#if defined(osCMSIS_FreeRTOS)
+	static constexpr uint32_t RESPONSE_READY_FLAG = 0x0001; // 响应就绪线程标志
+#endif
 
-	// --- 命令码 ---
-	static constexpr uint16_t CMD_AUTO_ENROLL = 0x0118;          // 自动注册
-	static constexpr uint16_t CMD_MATCH_SYNC = 0x0123;           // 同步 1:N 匹配
-	static constexpr uint16_t CMD_MATCH_ASYNC = 0x0121;          // 异步 1:N 匹配
-	static constexpr uint16_t CMD_QUERY_MATCH_RESULT = 0x0122;   // 查询匹配结果
-	static constexpr uint16_t CMD_DELETE_FINGER = 0x0131;        // 删除指纹
-	static constexpr uint16_t CMD_QUERY_FINGER_STATUS = 0x0135;  // 查询手指在位状态
-	static constexpr uint16_t CMD_GET_FINGER_COUNT = 0x0203;     // 获取指纹数量
-	static constexpr uint16_t CMD_HEARTBEAT = 0x0303;            // 心跳/初始化
-	static constexpr uint16_t CMD_SET_PASSWORD = 0x0305;         // 设置密码（写入Flash）
-	static constexpr uint16_t CMD_SET_PASSWORD_TEMP = 0x0201;    // 临时设置密码（掉电丢失）
-	static constexpr uint16_t CMD_UPDATE_FEATURE = 0x0116;       // 更新特征值（自学习）
-	static constexpr uint16_t CMD_GET_SYSTEM_POLICY = 0x02FB;    // 获取系统策略
-	static constexpr uint16_t CMD_SET_SYSTEM_POLICY = 0x02FC;    // 设置系统策略
-	static constexpr uint16_t CMD_ENTER_SLEEP_MODE = 0x020C;     // 进入休眠模式
-	static constexpr uint16_t CMD_SET_LED_CONTROL = 0x020F;      // 设置 LED 控制信息
-
-	// --- 缓冲区大小 ---
-	static constexpr size_t RX_BUFFER_SIZE = 256;
-	static constexpr size_t TX_BUFFER_SIZE = 256;
-	static constexpr uint8_t LINK_LAYER_HEADER_LEN = 11; // 帧头(8) + 长度(2) + 校验和(1)
+	// --- 命令码 (命令目录见 FPM383CCommandSet.h) ---
+	using ActiveCommands = FPM383CCommandSet::Active; // 编译期选定的命令集，决定缓冲区大小和可用的命令
+
+	static constexpr uint16_t CMD_AUTO_ENROLL = FPM383CCommandSet::AutoEnroll.Code;
+	static constexpr uint16_t CMD_MATCH_SYNC = FPM383CCommandSet::MatchSync.Code;
+	static constexpr uint16_t CMD_MATCH_ASYNC = FPM383CCommandSet::MatchAsync.Code;
+	static constexpr uint16_t CMD_QUERY_MATCH_RESULT = FPM383CCommandSet::QueryMatchResult.Code;
+	static constexpr uint16_t CMD_VERIFY = FPM383CCommandSet::Verify.Code;
+	static constexpr uint16_t CMD_CANCEL = FPM383CCommandSet::Cancel.Code;
+	static constexpr uint16_t CMD_DELETE_FINGER = FPM383CCommandSet::DeleteFinger.Code;
+	static constexpr uint16_t CMD_QUERY_FINGER_STATUS = FPM383CCommandSet::QueryFingerStatus.Code;
+	static constexpr uint16_t CMD_GET_FINGER_COUNT = FPM383CCommandSet::GetFingerCount.Code;
+	static constexpr uint16_t CMD_GET_ID_BITMAP = FPM383CCommandSet::GetIdBitmap.Code;
+	static constexpr uint16_t CMD_HEARTBEAT = FPM383CCommandSet::Heartbeat.Code;
+	static constexpr uint16_t CMD_SET_PASSWORD = FPM383CCommandSet::SetPassword.Code;
+	static constexpr uint16_t CMD_SET_BAUD_RATE = FPM383CCommandSet::SetBaudRate.Code;
+	static constexpr uint16_t CMD_SET_PASSWORD_TEMP = FPM383CCommandSet::SetPasswordTemp.Code;
+	static constexpr uint16_t CMD_UPDATE_FEATURE = FPM383CCommandSet::UpdateFeature.Code;
+	static constexpr uint16_t CMD_GET_SYSTEM_POLICY = FPM383CCommandSet::GetSystemPolicy.Code;
+	static constexpr uint16_t CMD_SET_SYSTEM_POLICY = FPM383CCommandSet::SetSystemPolicy.Code;
+	static constexpr uint16_t CMD_ENTER_SLEEP_MODE = FPM383CCommandSet::EnterSleepMode.Code;
+	static constexpr uint16_t CMD_SET_LED_CONTROL = FPM383CCommandSet::SetLEDControl.Code;
+	static constexpr uint16_t CMD_UPLOAD_TEMPLATE_START = FPM383CCommandSet::UploadTemplateStart.Code;
+	static constexpr uint16_t CMD_UPLOAD_TEMPLATE_DATA = FPM383CCommandSet::UploadTemplateData.Code;
+	static constexpr uint16_t CMD_DOWNLOAD_TEMPLATE_START = FPM383CCommandSet::DownloadTemplateStart.Code;
+	static constexpr uint16_t CMD_DOWNLOAD_TEMPLATE_DATA = FPM383CCommandSet::DownloadTemplateData.Code;
+
+	// 模板传输和修改密码不在命令集中时，对应方法直接返回 Unsupported，代码在编译期被裁掉
+	static constexpr bool SUPPORTS_TEMPLATE_TRANSFER = ActiveCommands::Contains(CMD_UPLOAD_TEMPLATE_DATA) && ActiveCommands::Contains(CMD_DOWNLOAD_TEMPLATE_DATA);
+	static constexpr bool SUPPORTS_SET_PASSWORD = ActiveCommands::Contains(CMD_SET_PASSWORD) && ActiveCommands::Contains(CMD_SET_PASSWORD_TEMP);
+
+
+	// --- 缓冲区大小 (由命令集中最大的请求/响应帧决定) ---
+	static constexpr size_t RX_BUFFER_SIZE = ActiveCommands::RX_BUFFER_SIZE;
+	static constexpr size_t TX_BUFFER_SIZE = ActiveCommands::TX_BUFFER_SIZE;
+	static constexpr size_t RX_RING_SIZE = 128; // 循环 DMA 环形缓冲区，HT/TC 事件保证半区满时即被处理
+	static constexpr size_t RX_SLOT_COUNT = 2;  // 帧重组器的接收槽位数，模板上传流水线需要同时持有两帧
+
+	// 发送缓冲区分为两半: 异步操作在前一半、取消在后一半中组帧 (取消应答后接着发出的匹配回到前一半)，
+	// 模板下载交替使用两半，每半必须能容纳一个完整的数据帧
+	static constexpr size_t TEMPLATE_CHUNK_SIZE = FPM383CCommandSet::TEMPLATE_CHUNK_SIZE;
+	static constexpr size_t TX_HALF_BUFFER_SIZE = ActiveCommands::TX_HALF_BUFFER_SIZE;
+	static_assert(!SUPPORTS_TEMPLATE_TRANSFER || FPM383CFrame::FrameSize(2 + TEMPLATE_CHUNK_SIZE) <= TX_HALF_BUFFER_SIZE, "Template chunk frame must fit in half of the TX buffer");
+	static_assert(FPM383CFrame::FrameSize(FPM383CCommandSet::AutoEnroll.MaxRequestPayload) <= TX_HALF_BUFFER_SIZE, "Async enroll frame must fit in half of the TX buffer");
+
+	// 收发缓冲区占用的 RAM，以及相对原先固定缓冲区 (一个 256 字节接收 + 一个 256 字节发送) 节省的 RAM，构建时由 CMake 报告
+	static constexpr size_t BUFFER_RAM_BYTES = RX_SLOT_COUNT * RX_BUFFER_SIZE + TX_BUFFER_SIZE;
+	static constexpr size_t BASELINE_BUFFER_RAM_BYTES = 256 + 256;
+	static_assert(BUFFER_RAM_BYTES <= BASELINE_BUFFER_RAM_BYTES, "FPM383C buffers must not exceed the fixed 256-byte RX + TX baseline");
+	static constexpr size_t BUFFER_RAM_SAVING_BYTES = BASELINE_BUFFER_RAM_BYTES - BUFFER_RAM_BYTES;
+
+	static constexpr uint8_t LINK_LAYER_HEADER_LEN = FPM383CFrame::LINK_LAYER_LEN; // 帧头(8) + 长度(2) + 校验和(1)
+	static constexpr uint8_t APP_LAYER_MIN_LEN = 11;     // 密码(4) + 命令(2) + 错误码(4) + 校验和(1)
+
+	/**
+	 * @brief 流式帧重组器
+	 * @details 逐字节输入，搜索帧头并在字节到达时累加校验和，输出完整且校验通过的帧
+	 *          拆分到多次接收事件或合并在一次事件中的帧都能被正确重组
+	 *          帧写入 RX_SLOT_COUNT 个槽位之一，完整帧按到达顺序排队，随后在另一个空闲槽位中继续重组，
+	 *          因此同一次 DMA 突发中紧跟的下一帧不会丢失；Release() 或 Lease() 取走队首的帧
+	 *          所有槽位都在排队或被借出时丢弃到达的字节
+	 */
+	class FrameAssembler {
+	public:
+		/**
+		 * @brief 输入一个字节
+		 * @return true 表示刚刚得到一个完整的帧 (已加入队列)
+		 */
+		bool Feed(uint8_t byte);
+
+		// 释放队首的完整帧 (已借出的槽位不受影响)
+		void Release();
+
+		// 丢弃所有排队的完整帧和未完成的帧，重新开始搜索帧头
+		void Reset();
+
+		// 是否有排队的完整帧
+		inline bool HasFrame() const { return _readyCount != 0; }
+
+		// 队首的完整帧 (链路层 + 应用层)
+		inline std::span<const uint8_t> Frame() const {
+			const uint8_t slot = _readyQueue[_readyHead];
+			return { _frames[slot].data(), _frameLengths[slot] };
+		}
+
+		/**
+		 * @brief 借出队首完整帧所在的槽位，该帧随之出队
+		 * @details 必须与 Feed() 互斥 (在临界区中调用)
+		 * @return 槽位占用标志，由 ResponseLease 在释放时清除；没有完整帧时返回 nullptr
+		 */
+		volatile bool *Lease();
+
+	private:
+		enum class State : uint8_t {
+			Header,   // 搜索帧头
+			Length,   // 接收应用层数据长度
+			Checksum, // 接收链路层校验和
+			AppData   // 接收应用层数据
+		};
+
+		static constexpr uint8_t NO_SLOT = 0xFF;
+
+		State _state = State::Header;
+		uint16_t _index = 0;        // 已写入当前槽位的字节数
+		uint16_t _appDataLen = 0;   // 应用层数据长度
+		uint8_t _sum = 0;           // 当前校验区段的累加和
+		uint8_t _slot = NO_SLOT;    // 当前写入的槽位
+		uint8_t _readyHead = 0;     // 队首在 _readyQueue 中的位置
+		uint8_t _readyCount = 0;    // 排队的完整帧数
+
+		// 丢弃未完成的帧，重新搜索帧头
+		inline void _restart() {
+			_state = State::Header;
+			_index = 0;
+		}
+
+		// 选择一个既未排队也未借出的槽位写入，没有时返回 false
+		bool _acquireSlot();
+
+		std::array<std::array<uint8_t, RX_BUFFER_SIZE>, RX_SLOT_COUNT> _frames; // 帧缓冲区槽位
+		std::array<uint16_t, RX_SLOT_COUNT> _frameLengths{};                     // 各槽位中完整帧的长度
+		std::array<uint8_t, RX_SLOT_COUNT> _readyQueue{};                        // 完整帧所在槽位 (按到达顺序)
+		std::array<bool, RX_SLOT_COUNT> _isQueued{};                             // 槽位是否在完整帧队列中
+		std::array<volatile bool, RX_SLOT_COUNT> _isLeased{};                    // 槽位是否被租约占用
+	};
 
 	// --- 内部状态 ---
 	enum class CurrentOperation {
 		None,        // 无进行中的操作
 		AsyncMatch,  // 异步匹配中
-		AsyncEnroll  // 异步注册中
+		AsyncEnroll, // 异步注册中
+		Batch,       // 批处理中
+		Cancelling,  // 等待取消应答
+		Recovering,  // 异步恢复中，等待分发任务发出下一次探测
+		RecoveryWait // 异步恢复中，等待断电保持 (或发送失败后的一次探测时间) 结束
+	};
+
+	// 批处理结果的去向
+	enum class BatchOwner : uint8_t {
+		Caller,   // 阻塞等待的 RunBatch() 调用任务
+		Callback, // 批处理回调或等待中的协程 (StartAsyncBatch)
+		Recovery  // 异步恢复的心跳探测
 	};
 
 	// --- 私有方法 ---
-	CommandResult _sendCommandAndGetResponse(uint16_t command, std::span<const uint8_t> payload, std::span<uint8_t> &responsePayload, uint32_t timeout);
-	CommandResult _handleAutoEnrollment(uint16_t fingerId, uint8_t requiredPresses, EnrollStatus &finalStatus, const std::function<void(const EnrollStatus &)> &progressCallback);
+	CommandResult _sendCommandAndGetResponse(std::span<const uint8_t> frame, std::span<uint8_t> &responsePayload, uint32_t timeout);
+	Status _transmitCommand(std::span<const uint8_t> frame);
+	CommandResult _awaitResponse(std::span<uint8_t> &responsePayload, uint32_t timeout);
+	CommandResult _awaitResponse(ResponseLease &response, uint32_t timeout);
+
+	// 需要学习往返时间的命令 (响应时间只取决于链路和模块固件，与用户操作无关)
+	static constexpr std::array<uint16_t, 8> ADAPTIVE_COMMANDS = {
+		CMD_HEARTBEAT,
+		CMD_QUERY_FINGER_STATUS,
+		CMD_SET_LED_CONTROL,
+		CMD_ENTER_SLEEP_MODE,
+		CMD_GET_FINGER_COUNT,
+		CMD_GET_SYSTEM_POLICY,
+		CMD_UPLOAD_TEMPLATE_DATA,
+		CMD_DOWNLOAD_TEMPLATE_DATA
+	};
 
+	RttEstimator *_findRttEstimator(uint16_t command);
+	uint32_t _timeoutFor(uint16_t command, uint32_t timeout);
+	void _recordRtt(uint16_t command, uint32_t sentTick);
+	std::span<uint8_t> _txHalf(size_t index);
+	CommandResult _handleAutoEnrollment(uint16_t fingerId, uint8_t requiredPresses, EnrollStatus &finalStatus, const EnrollCallback &progressCallback);
+
+	void _consumeRx(uint16_t size);
+	void _onFrameAssembled();
 	void _handleAsyncResponse();
-	Status _startAsyncOperation(uint16_t command, std::span<const uint8_t> payload, CurrentOperation op);
+	void _armAsyncDeadline(uint32_t timeoutMs);
+	void _startDeadlineTimer(uint32_t timeoutMs);
+	void _onAsyncDeadline();
+	void _handleCancelResponse(bool isParsed, ModuleErrorCode errCode);
+	Status _startMatchOperation(uint16_t fingerId, bool preemptEnroll);
+	Status _startCancel(bool isMatchPending);
+	void _restoreCancelledOperation();
+	void _startPendingMatch();
+
+	// 完成记录: 接收回调中得到的异步结果，由 DispatchCompletions() 交给回调
+	enum class CompletionKind : uint8_t {
+		Match,          // 异步匹配结果
+		EnrollProgress, // 异步注册进度
+		EnrollComplete, // 异步注册完成
+		Batch,          // 异步批处理结果
+		RecoveryProbe,  // 异步恢复的一次心跳探测结果 (驱动内部处理)
+		RecoveryWait    // 异步恢复的等待结束 (驱动内部处理)
+	};
+
+	// 批处理结果在完成记录中的形式 (BatchResult 含 std::pair，不能直接放入联合体)
+	struct BatchFields {
+		Status Result;
+		ModuleErrorCode ErrorCode;
+		uint8_t CompletedCount;
+		uint8_t FailedIndex;
+
+		inline BatchResult ToResult() const { return { { Result, ErrorCode }, CompletedCount, FailedIndex }; }
+	};
+
+	struct CompletionRecord {
+		CompletionKind Kind = CompletionKind::Match;
+		union {
+			MatchResult Match;
+			EnrollStatus Enroll;
+			BatchFields Batch;
+		};
+
+		CompletionRecord() : Match() { }
+		explicit CompletionRecord(const MatchResult &match) : Kind(CompletionKind::Match), Match(match) { }
+		CompletionRecord(CompletionKind kind, const EnrollStatus &enroll) : Kind(kind), Enroll(enroll) { }
+		CompletionRecord(CompletionKind kind, const BatchResult &batch)
+			: Kind(kind), Batch{ batch.Result.first, batch.Result.second, batch.CompletedCount, batch.FailedIndex } { }
+	};
+
+	// 写入完成记录并通知，队列已满时丢弃 (接收回调或定时器任务中调用)
+	void _postCompletion(const CompletionRecord &record);
+	void _postAborted(CurrentOperation cancelled, ModuleErrorCode errCode);
+	void _handleBatchResponse(bool isParsed, ModuleErrorCode errCode);
+	Status _startBatch(std::span<const BatchCommand> commands, bool abortOnFailure);
+	Status _startOwnedBatch(std::span<const BatchCommand> commands, bool abortOnFailure, BatchOwner owner, uint32_t timeoutMs);
+	uint32_t _batchTimeout(std::span<const BatchCommand> commands);
+	Status _advanceBatch();
+	bool _transmitBatchCommand();
+	void _finishBatch();
+	void _reportBatch();
+
+	// 模块休眠状态
+	enum class SleepState : uint8_t {
+		Unknown,      // 未知
+		Awake,        // 已唤醒 (刚响应过命令)
+		Sleeping,     // 普通休眠
+		DeepSleeping  // 深度休眠
+	};
+
+	/**
+	 * @brief 模块状态影子
+	 * @details 记录最后一次被模块确认的 LED、休眠与策略状态，用于省略效果已生效的命令
+	 *          - SetLEDControl / EnterSleepMode / GetSystemPolicy 成功后记录对应状态
+	 *          - 其他命令的成功响应说明模块已唤醒；匹配、注册等会驱动 LED 的命令使 LED 状态失效
+	 *          - 任何失败 (超时、模块错误、解析失败、UART 错误) 使全部状态失效
+	 *          手指触摸唤醒模块时没有通信，因此休眠前应先查询手指状态 (FPM383CTask 即如此)
+	 */
+	struct ModuleShadow {
+		bool IsLEDKnown = false;
+		std::array<uint8_t, 5> LEDPayload{};  // 最后一次成功的 LED 控制负载
+		SleepState Sleep = SleepState::Unknown;
+		bool IsPolicyKnown = false;
+		SystemPolicy Policy;
+	};
+
+	bool _isRedundant(uint16_t command, std::span<const uint8_t> payload) const;
+	void _updateShadow(uint16_t command, std::span<const uint8_t> payload, Status status);
+	Status _startAsyncOperation(std::span<const uint8_t> frame, CurrentOperation op);
 
 	size_t _buildPacket(uint16_t command, std::span<const uint8_t> payload);
+	size_t _buildPacket(std::span<uint8_t> buffer, uint16_t command, std::span<const uint8_t> payload);
+	size_t _sealPacket(std::span<uint8_t> buffer, uint16_t command, size_t payloadLen);
+
+	/**
+	 * @brief 获取负载固定命令的完整帧
+	 * @details 使用默认密码时直接返回 Flash 中的编译期帧 (DMA 可直接发送)，否则在发送缓冲区中构造
+	 *          异步操作进行中时发送缓冲区可能仍在被 DMA 读取，此时返回空帧 (调用方随后会返回 Busy)
+	 */
+	template <uint16_t Command, uint8_t... Payload>
+	inline std::span<const uint8_t> _fixedFrame() {
+		if (_password == DEFAULT_PASSWORD) {
+			return FPM383CFrame::Frame<Command, DEFAULT_PASSWORD, Payload...>;
+		}
+		if (_currentOperation != CurrentOperation::None) return {};
+		static constexpr std::array<uint8_t, sizeof...(Payload)> payload = { Payload... };
+		return { _txBuffer.data(), _buildPacket(Command, payload) };
+	}
+
+	/**
+	 * @brief 在发送缓冲区中构造负载可变命令的完整帧
+	 * @details 使用默认密码时拷贝编译期生成的固定前缀，只计算负载部分的校验和
+	 */
+	template <uint16_t Command, size_t PayloadLen>
+	inline std::span<const uint8_t> _prefixedFrame(std::span<const uint8_t, PayloadLen> payload) {
+		if (_currentOperation != CurrentOperation::None) return {};
+		if (_password == DEFAULT_PASSWORD) {
+			using Prefix = FPM383CFrame::Prefix<Command, PayloadLen, DEFAULT_PASSWORD>;
+			return { _txBuffer.data(), Prefix::Write(_txBuffer, payload) };
+		}
+		return { _txBuffer.data(), _buildPacket(Command, payload) };
+	}
 	bool _parsePacket(std::span<const uint8_t> rxData, uint16_t &ackCommand, ModuleErrorCode &errorCode, std::span<uint8_t> &responsePayload);
 
+	// 标记链路中断并记录时刻，已中断时保持最早的时刻 (可在 ISR 中调用)
+	void _markLinkDown();
+	// 发送心跳，模块应答 (含错误码) 即认为链路正常
+	bool _probeLink(uint32_t timeout);
+	// 上电后持续探测，直到模块应答心跳或超过 POWER_UP_TIMEOUT_MS (Init() 中使用)
+	bool _awaitPowerUp();
+	// 选择起始级别并记录开始时的波特率 (同步与异步恢复共用)
+	void _beginRecovery();
+	// 推进到下一次心跳探测，所有级别都失败时返回 false
+	bool _nextRecoveryProbe(uint32_t &powerOffMs);
+	// 断电保持结束后重新上电，上电窗口从此刻起算
+	void _powerOnForRecovery();
+	// 记录恢复统计，返回恢复链路的级别或 Failed
+	RecoveryLevel _finishRecovery(bool isRecovered);
+	// 异步恢复: 发出下一次探测、以批处理发出心跳、进入等待、结束并回调 (均在任务中调用)
+	void _advanceRecovery();
+	void _startRecoveryProbe();
+	void _waitForRecovery(uint32_t timeoutMs);
+	void _completeRecovery(bool isRecovered);
+
+	// 匹配结果解码 (同步匹配、1:1 比对与异步匹配 0x0121 的应答共用)，负载长度不足时返回 false
+	static bool _decodeMatch(std::span<const uint8_t> payload, MatchResult &result);
+	// 注册进度解码 (同步与异步注册共用)，负载长度不足时返回 false
+	static bool _decodeEnrollProgress(std::span<const uint8_t> payload, EnrollStatus &status);
+
+	// 以绝对符号导出收发缓冲区大小，供构建后的 RAM 报告读取
+	[[gnu::used]] static void _exportBufferSizes();
+
 	// 校验和计算: 取反加一
 	static inline constexpr uint8_t _calculateChecksum(std::span<const uint8_t> data) {
-		uint8_t sum = std::accumulate(data.begin(), data.end(), static_cast<uint8_t>(0));
-		return ~sum + 1;
+		return FPM383CFrame::Checksum(data);
 	}
 
 	// --- 平台抽象 ---
-	// UART 发送函数（DMA 方式）
-	inline bool _uartTransmit(uint16_t size) {
+	// UART 发送函数（DMA 方式），帧可位于发送缓冲区或 Flash 中
+	inline bool _uartTransmit(std::span<const uint8_t> frame) {
+#if defined(USE_HAL_DRIVER)
+		return HAL_UART_Transmit_DMA(_huart, frame.data(), static_cast<uint16_t>(frame.size())) == HAL_OK;
+#elif defined(ESP_PLATFORM)
+		return uart_write_bytes(_huart, frame.data(), frame.size()) == static_cast<int>(frame.size());
+#endif
+	}
+
+	// 中止接收并丢弃半帧，下一条命令发出前重新启动环形接收
+	inline void _abortRx() {
+#if defined(USE_HAL_DRIVER)
+		HAL_UART_AbortReceive(_huart);
+		_isRxRunning = false;
+#elif defined(ESP_PLATFORM)
+		uart_flush_input(_huart);
+#endif
+		_assembler.Reset();
+	}
+
+	// 确保 UART 接收处于运行状态（循环 DMA + 空闲中断方式，只需启动一次）
+	inline bool _ensureRxRunning() {
+#if defined(USE_HAL_DRIVER)
+		if (_isRxRunning) return true;
+		_rxTail = 0;
+		_isRxRunning = HAL_UARTEx_ReceiveToIdle_DMA(_huart, _rxRing.data(), _rxRing.size()) == HAL_OK;
+		return _isRxRunning;
+#elif defined(ESP_PLATFORM)
+		return true; // ESP-IDF UART 驱动自带环形缓冲区
+#endif
+	}
+
+	// 丢弃尚未处理的接收数据，并重新开始搜索帧头
+	inline void _flushRx() {
+		const uint32_t state = _enterCritical();
+#if defined(USE_HAL_DRIVER)
+		if (_isRxRunning) {
+			_rxTail = (RX_RING_SIZE - __HAL_DMA_GET_COUNTER(_huart->hdmarx)) % RX_RING_SIZE;
+		}
+#elif defined(ESP_PLATFORM)
+		uart_flush_input(_huart);
+#endif
+		_assembler.Reset();
+		_exitCritical(state);
+	}
+
+	// 释放已处理完的队首帧并准备等待下一帧，已排队的下一帧立即唤醒等待
+	inline void _releaseFrame() {
+		_prepareResponseWait();
+		const uint32_t state = _enterCritical();
+		_assembler.Release();
+		const bool hasNext = _assembler.HasFrame();
+		_exitCritical(state);
+		if (hasNext) {
+			_signalResponseReady();
+		}
+	}
+
+	// 进入临界区 (与 UART 接收回调互斥)
+	inline uint32_t _enterCritical() {
 #if defined(USE_HAL_DRIVER)
-		return HAL_UART_Transmit_DMA(_huart, _txBuffer.data(), size) == HAL_OK;
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		return primask;
 #elif defined(ESP_PLATFORM)
-		return uart_write_bytes(_huart, _txBuffer.data(), size) == size;
+		portENTER_CRITICAL(&_spinlock);
+		return 0;
 #endif
 	}
 
-	// UART 接收函数（DMA 空闲中断方式）
-	inline bool _uartReceive() {
+	// 退出临界区
+	inline void _exitCritical(uint32_t state) {
 #if defined(USE_HAL_DRIVER)
-		return HAL_UARTEx_ReceiveToIdle_DMA(_huart, _rxBuffer.data(), _rxBuffer.size()) == HAL_OK;
+		__set_PRIMASK(state);
+#elif defined(ESP_PLATFORM)
+		(void)state;
+		portEXIT_CRITICAL(&_spinlock);
+#endif
+	}
+
+	// --- 响应等待原语 ---
+	// 由 UartRxCallback 直接唤醒等待中的任务，超时由阻塞等待本身处理，不再轮询
+	// - FreeRTOS (CMSIS OS V2): 线程标志 (osThreadFlags)
+	// - ESP-IDF: 任务通知 (Task Notification)
+	// - STM32 HAL (无OS): 标志位 + WFI 休眠等待中断
+
+	// 准备等待响应，必须在启动接收和发送命令之前调用
+	inline void _prepareResponseWait() {
+		_isResponseReady = false;
+#if defined(osCMSIS_FreeRTOS)
+		_waitingThread = osThreadGetId();
+		osThreadFlagsClear(RESPONSE_READY_FLAG);
 #elif defined(ESP_PLATFORM)
-		return true; // ESP-IDF DMA is event-driven
+		_waitingTask = xTaskGetCurrentTaskHandle();
+		ulTaskNotifyTake(pdTRUE, 0); // 清除残留的通知
 #endif
 	}
 
-	// 电源控制 (低电平有效)
+	// 阻塞等待响应就绪，返回 false 表示超时
+	inline bool _waitForResponse(uint32_t timeout) {
+#if defined(osCMSIS_FreeRTOS)
+		const uint32_t flags = osThreadFlagsWait(RESPONSE_READY_FLAG, osFlagsWaitAny, timeout);
+		return (flags & osFlagsError) == 0 || _isResponseReady;
+#elif defined(ESP_PLATFORM)
+		return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout)) != 0 || _isResponseReady;
+#elif defined(USE_HAL_DRIVER)
+		const uint32_t startTime = HAL_GetTick();
+		while (!_isResponseReady) {
+			if (HAL_GetTick() - startTime > timeout) {
+				return false;
+			}
+			__WFI(); // 休眠至下一个中断 (UART 空闲中断或 SysTick)
+		}
+		return true;
+#endif
+	}
+
+	// 唤醒等待响应的任务 (STM32 在 ISR 中调用，ESP-IDF 在 UART 事件任务中调用)
+	inline void _signalResponseReady() {
+		_isResponseReady = true;
+#if defined(osCMSIS_FreeRTOS)
+		if (_waitingThread != nullptr) {
+			osThreadFlagsSet(_waitingThread, RESPONSE_READY_FLAG);
+		}
+#elif defined(ESP_PLATFORM)
+		if (_waitingTask != nullptr) {
+			xTaskNotifyGive(_waitingTask);
+		}
+#endif
+	}
+
+	// 重新配置 UART 波特率并重启接收
+	inline bool _setUartBaudRate(uint32_t baudRate) {
+#if defined(USE_HAL_DRIVER)
+		// 停止环形接收后重新初始化，句柄已初始化过，HAL_UART_Init 不会再次调用 MspInit
+		HAL_UART_Abort(_huart);
+		_isRxRunning = false;
+		_huart->Init.BaudRate = baudRate;
+		const bool isOk = HAL_UART_Init(_huart) == HAL_OK;
+#elif defined(ESP_PLATFORM)
+		const bool isOk = uart_set_baudrate(_huart, baudRate) == ESP_OK;
+#endif
+		_assembler.Reset();
+		if (isOk) {
+			_baudRate = baudRate;
+			// 往返时间随波特率变化，重新学习
+			for (auto &estimator : _rttEstimators) {
+				estimator.Reset();
+			}
+		}
+		return isOk && _ensureRxRunning();
+	}
+
+	// 电源控制 (低电平有效)，没有电源引脚时不做任何事
 	inline void _setPower(bool on) {
 		if (!_powerPin) return;
 #if defined(USE_HAL_DRIVER)
@@ -429,21 +1428,131 @@ private:
 	PortPinPair _touchPin;       // 触摸感应引脚
 	PortPinPair *_powerPin;      // 电源控制引脚 (可选)
 	uint32_t _password = DEFAULT_PASSWORD; // 通信密码
-
-	std::array<uint8_t, RX_BUFFER_SIZE> _rxBuffer; // 接收缓冲区
+	uint32_t _baudRate = DEFAULT_BAUD_RATE; // 当前链路波特率
+	uint32_t _targetBaudRate = 0;           // Init() 协商的目标波特率，0 表示未协商 (恢复链路时同样探测)
+
+	// 自适应超时
+	std::array<RttEstimator, ADAPTIVE_COMMANDS.size()> _rttEstimators{}; // 与 ADAPTIVE_COMMANDS 一一对应
+	uint32_t _timeoutFloorMs = DEFAULT_TIMEOUT_FLOOR_MS;
+	uint32_t _timeoutCeilingMs = DEFAULT_TIMEOUT_MS;
+	uint16_t _inFlightCommand = 0;         // 最近一次发出的命令，命令码不同的应答被当作迟到的应答丢弃
+	uint32_t _commandSentTick = 0;         // 最近一次命令的发出时刻
+	volatile uint32_t _responseTick = 0;   // 最近一次完整响应的到达时刻 (在接收回调中记录)
+
+	std::array<uint8_t, RX_RING_SIZE> _rxRing;     // 循环 DMA 接收环形缓冲区
 	std::array<uint8_t, TX_BUFFER_SIZE> _txBuffer; // 发送缓冲区
+	FrameAssembler _assembler;                     // 流式帧重组器 (持有接收到的完整帧)
+	uint16_t _rxTail = 0;                          // 环形缓冲区读取位置
+	bool _isRxRunning = false;                     // 循环 DMA 接收是否已启动
+#if defined(ESP_PLATFORM)
+	portMUX_TYPE _spinlock = portMUX_INITIALIZER_UNLOCKED;
+#endif
 
 	// 同步调用状态
-	bool _isResponseReady = false;  // 响应就绪标志
-	uint16_t _lastRxSize = 0;       // 最后接收到的数据长度
+	volatile bool _isResponseReady = false;  // 响应就绪标志
+#if defined(osCMSIS_FreeRTOS)
+	osThreadId_t _waitingThread = nullptr;   // 等待响应的线程
+#elif defined(ESP_PLATFORM)
+	TaskHandle_t _waitingTask = nullptr;     // 等待响应的任务
+#endif
 
 	// 异步操作状态
 	CurrentOperation _currentOperation = CurrentOperation::None;
 	uint16_t _asyncEnrollFingerId = 0;         // 异步注册的指纹 ID
 	uint8_t _asyncEnrollRequiredPresses = 0;   // 异步注册需要的按压次数
+	uint16_t _asyncVerifyFingerId = MATCH_ANY_ID; // 异步 1:1 比对的指纹 ID，MATCH_ANY_ID 表示 1:N 匹配
+	bool _isMatchPending = false;              // 取消应答到达后由接收回调发出匹配命令
+	CurrentOperation _cancelledOperation = CurrentOperation::None; // 正在取消的操作，取消未生效时恢复
+	uint16_t _cancelledCommand = 0;            // 正在取消的操作的在途命令码
+	uint32_t _cancelledTimeoutMs = 0;          // 正在取消的操作的截止时间长度
+	uint32_t _cancelledActivityTick = 0;       // 正在取消的操作最近一次活动的时刻
+	CommandResult _cancelResult;               // 取消应答的结果 (由接收回调写入)
+	uint32_t _asyncTimeoutMs = 0;              // 当前异步操作的截止时间长度
+	volatile uint32_t _asyncActivityTick = 0;  // 异步操作开始或最近一次进度应答的时刻
+#if defined(osCMSIS_FreeRTOS)
+	osTimerId_t _asyncDeadlineTimer = nullptr;       // 截止时间定时器 (单次，首次启动异步操作时创建)
+	StaticTimer_t _asyncDeadlineTimerControlBlock{};
+#elif defined(ESP_PLATFORM)
+	TimerHandle_t _asyncDeadlineTimer = nullptr;
+	StaticTimer_t _asyncDeadlineTimerControlBlock{};
+#endif
+
+	// 批处理状态
+	std::span<const BatchCommand> _batchCommands; // 当前批处理的命令列表
+	BatchResult _batchResult;                     // 当前批处理的汇总结果
+	uint8_t _batchIndex = 0;                      // 当前等待响应的命令索引
+	bool _batchAbortOnFailure = true;             // 失败时是否中止
+	BatchOwner _batchOwner = BatchOwner::Caller;  // 结果的去向
+	std::array<BatchCommand, 1> _featureUpdateBatch{}; // StartDeferredFeatureUpdate() 的命令 (批处理期间保持有效)
+
+	// 模块状态影子
+	ModuleShadow _shadow;
+	ShadowStats _shadowStats;
+
+	// 链路恢复
+	volatile bool _isLinkDown = false;                       // 链路被判定为中断
+	volatile uint32_t _linkDownTick = 0;                     // 检测到中断的时刻
+	RecoveryLevel _lastRecoveryLevel = RecoveryLevel::None;  // 上一次恢复成功的级别
+	uint32_t _lastRecoveryTick = 0;                          // 上一次恢复成功的时刻
+	RecoveryStats _recoveryStats;
+
+	// 恢复进度 (同步 Recover() 与异步 StartRecovery() 共用)
+	struct RecoveryCursor {
+		RecoveryLevel Level = RecoveryLevel::None;    // 当前级别
+		RecoveryLevel MaxLevel = RecoveryLevel::None; // 最高级别 (没有电源引脚时为 Resync)
+		uint8_t Step = 0;                             // 本级已开始的步骤数
+		bool IsPoweredOff = false;                    // PowerCycle: 断电保持中
+		uint32_t BaudRate = 0;                        // 开始恢复时的波特率
+		uint32_t PowerOnTick = 0;                     // PowerCycle: 重新上电的时刻
+	};
+	RecoveryCursor _recovery;
+
+	// 延迟自学习
+	static constexpr uint16_t NO_DEFERRED_FEATURE_UPDATE = 0xFFFF;
+	static constexpr uint16_t MATCH_ANY_ID = 0xFFFF;
+	uint16_t _deferredFeatureUpdateId = NO_DEFERRED_FEATURE_UPDATE; // 待自学习的 ID
+
+	// 未经实物验证的可选命令，首次使用时探测
+	enum class CommandSupport : uint8_t {
+		Unknown,     // 尚未探测
+		Supported,   // 模块已正常应答
+		Unsupported  // 模块无应答或拒绝该命令码，之后不再发送
+	};
+	CommandSupport _idBitmapSupport = CommandSupport::Unknown; // 获取 ID 位图
+	CommandSupport _cancelSupport = CommandSupport::Unknown; // 取消
+	CommandSupport _verifySupport = ActiveCommands::Contains(CMD_VERIFY) ? CommandSupport::Unknown : CommandSupport::Unsupported; // 1:1 比对
 
 	// 异步回调函数
-	std::function<void(const MatchResult &)> _matchCallback;           // 匹配完成回调
-	std::function<void(const EnrollStatus &)> _enrollProgressCallback; // 注册进度回调
-	std::function<void(const EnrollStatus &)> _enrollCompleteCallback; // 注册完成回调
+	MatchCallback _matchCallback;           // 匹配完成回调
+	EnrollCallback _enrollProgressCallback; // 注册进度回调
+	EnrollCallback _enrollCompleteCallback; // 注册完成回调
+	BatchCallback _batchCallback;           // 异步批处理完成回调
+	RecoveryCallback _recoveryCallback;     // 异步恢复完成回调
+
+	// 等待异步操作结果的协程: 在任务中设置 (启动操作之前)，由 DispatchCompletions() 写入结果并交给恢复调度器
+	template<typename T>
+	struct CoroutineWaiter {
+		std::coroutine_handle<> Handle;
+		T *Result = nullptr;
+	};
+	template<typename T>
+	bool _resumeWaiter(CoroutineWaiter<T> &waiter, const T &result);
+	inline bool _hasMatchListener() const { return _matchCallback || _matchWaiter.Handle; }
+	inline bool _hasEnrollCompleteListener() const { return _enrollCompleteCallback || _enrollWaiter.Handle; }
+	inline bool _hasBatchListener() const { return _batchCallback || _batchWaiter.Handle; }
+
+	ResumeScheduler _resumeScheduler = nullptr;         // 协程恢复调度器
+	CoroutineWaiter<MatchResult> _matchWaiter;          // 等待匹配结果的协程
+	CoroutineWaiter<EnrollStatus> _enrollWaiter;        // 等待注册完成的协程
+	CoroutineWaiter<BatchResult> _batchWaiter;          // 等待批处理结果的协程
+	CoroutineWaiter<RecoveryLevel> _recoveryWaiter;     // 等待链路恢复的协程
+
+	static_assert((COMPLETION_QUEUE_LENGTH & (COMPLETION_QUEUE_LENGTH - 1)) == 0 && COMPLETION_QUEUE_LENGTH <= 128,
+		"Completion queue length must be a power of two that fits the 8-bit free-running indices");
+	// 完成队列: 生产者 (接收回调、定时器任务) 在临界区中写入，单消费者 (DispatchCompletions) 在任务中读取
+	std::array<CompletionRecord, COMPLETION_QUEUE_LENGTH> _completions;
+	volatile uint8_t _completionHead = 0;    // 下一条待分发的记录 (自由计数，取模得到下标)
+	volatile uint8_t _completionTail = 0;    // 下一条记录的写入位置
+	CompletionNotifier _completionNotifier;  // 入队后的通知
+	IsrStats _isrStats;
 };
\ No newline at end of file
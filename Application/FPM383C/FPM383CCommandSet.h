@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "FPM383CFrame.h"
+
+/**
+ * @brief FPM383C 命令集的编译期描述
+ * @details 每条命令以 命令码 + 请求负载上限 + 响应负载上限 描述，固件使用的命令组成命令集，
+ *          驱动的收发缓冲区按命令集中可能出现的最大帧分配，命令集之外的命令在编译期被裁掉
+ *
+ *          默认使用 DoorOpener 命令集 (门禁固件实际用到的命令)，
+ *          定义 FPM383C_FULL_COMMAND_SET 时使用 Full 命令集 (含模板传输和修改密码)，
+ *          CMake 选项 FPM383C_FULL_COMMAND_SET 会定义该宏
+ */
+namespace FPM383CCommandSet {
+	inline constexpr size_t TEMPLATE_CHUNK_SIZE = 96; // 模板传输每块的数据长度
+	inline constexpr size_t ERROR_CODE_LEN = 4;       // 响应中位于负载之前的错误码
+
+	// 一条命令及其在帧中可能携带的最大负载
+	struct Command {
+		uint16_t Code;
+		uint16_t MaxRequestPayload;
+		uint16_t MaxResponsePayload;
+	};
+
+	// --- 命令目录 ---
+	inline constexpr Command AutoEnroll = { 0x0118, 4, 5 };           // 自动注册: 负载 按压次数(1) + ID(2) + 参数(1)，响应 注册进度(5)
+	inline constexpr Command MatchSync = { 0x0123, 0, 6 };            // 同步 1:N 匹配: 响应 结果(2) + 分数(2) + ID(2)
+	inline constexpr Command MatchAsync = { 0x0121, 0, 6 };           // 异步 1:N 匹配
+	inline constexpr Command QueryMatchResult = { 0x0122, 0, 6 };     // 查询匹配结果
+	inline constexpr Command Verify = { 0x0124, 2, 6 };               // 同步 1:1 比对: 负载 ID(2)，响应同 1:N 匹配 (未在实物模块上验证)
+	inline constexpr Command Cancel = { 0x0130, 0, 0 };               // 取消注册或匹配 (未在实物模块上验证)
+	inline constexpr Command DeleteFinger = { 0x0131, 5, 0 };         // 删除指纹: 负载 模式(1) + ID(2) + 数量(2)
+	inline constexpr Command QueryFingerStatus = { 0x0135, 0, 1 };    // 查询手指在位状态
+	inline constexpr Command GetFingerCount = { 0x0203, 0, 2 };       // 获取指纹数量
+	inline constexpr Command GetIdBitmap = { 0x0204, 0, 32 };         // 获取 ID 占用位图: 按 256 个 ID 估计 (未在实物模块上验证)
+	inline constexpr Command Heartbeat = { 0x0303, 0, 0 };            // 心跳/初始化
+	inline constexpr Command SetPassword = { 0x0305, 4, 0 };          // 设置密码（写入Flash）
+	inline constexpr Command SetBaudRate = { 0x0304, 4, 0 };          // 设置波特率 (未在实物模块上验证)
+	inline constexpr Command SetPasswordTemp = { 0x0201, 4, 0 };      // 临时设置密码（掉电丢失）
+	inline constexpr Command UpdateFeature = { 0x0116, 2, 0 };        // 更新特征值（自学习）
+	inline constexpr Command GetSystemPolicy = { 0x02FB, 0, 4 };      // 获取系统策略
+	inline constexpr Command SetSystemPolicy = { 0x02FC, 4, 0 };      // 设置系统策略
+	inline constexpr Command EnterSleepMode = { 0x020C, 1, 0 };       // 进入休眠模式
+	inline constexpr Command SetLEDControl = { 0x020F, 5, 0 };        // 设置 LED 控制信息
+
+	// 模板传输命令 (依据手册模板上传/下载章节整理，尚未在实物模块上验证)
+	inline constexpr Command UploadTemplateStart = { 0x0141, 2, 2 };                          // 开始上传模板: 负载 ID(2)，响应 模板大小(2)
+	inline constexpr Command UploadTemplateData = { 0x0142, 2, 2 + TEMPLATE_CHUNK_SIZE };     // 上传模板数据: 负载 块序号(2)，响应 块序号(2) + 数据
+	inline constexpr Command DownloadTemplateStart = { 0x0143, 4, 0 };                        // 开始下载模板: 负载 ID(2) + 模板大小(2)
+	inline constexpr Command DownloadTemplateData = { 0x0144, 2 + TEMPLATE_CHUNK_SIZE, 0 };   // 下载模板数据: 负载 块序号(2) + 数据
+
+	/**
+	 * @brief 由若干命令组成的命令集
+	 * @tparam Commands 命令集包含的命令
+	 * @details 发送缓冲区分为两半 (异步注册和取消在第二半中组帧，模板下载交替使用两半)，
+	 *          因此每半都要能容纳最大的请求帧；响应帧在负载之前还有 4 字节错误码
+	 */
+	template <Command... Commands>
+	struct Set {
+		static constexpr bool Contains(uint16_t code) {
+			return ((Commands.Code == code) || ...);
+		}
+
+		static constexpr size_t MAX_REQUEST_PAYLOAD = std::max({ size_t{ 0 }, size_t{ Commands.MaxRequestPayload }... });
+		static constexpr size_t MAX_RESPONSE_PAYLOAD = std::max({ size_t{ 0 }, size_t{ Commands.MaxResponsePayload }... });
+
+		static constexpr size_t TX_HALF_BUFFER_SIZE = FPM383CFrame::FrameSize(MAX_REQUEST_PAYLOAD);
+		static constexpr size_t TX_BUFFER_SIZE = 2 * TX_HALF_BUFFER_SIZE;
+		static constexpr size_t RX_BUFFER_SIZE = FPM383CFrame::FrameSize(ERROR_CODE_LEN + MAX_RESPONSE_PAYLOAD);
+	};
+
+	// 驱动支持的全部命令
+	using Full = Set<AutoEnroll, MatchSync, MatchAsync, QueryMatchResult, Verify, Cancel, DeleteFinger, QueryFingerStatus,
+		GetFingerCount, GetIdBitmap, Heartbeat, SetPassword, SetBaudRate, SetPasswordTemp, UpdateFeature,
+		GetSystemPolicy, SetSystemPolicy, EnterSleepMode, SetLEDControl,
+		UploadTemplateStart, UploadTemplateData, DownloadTemplateStart, DownloadTemplateData>;
+
+	// 门禁固件使用的命令: 不含模板传输和修改密码
+	using DoorOpener = Set<AutoEnroll, MatchSync, MatchAsync, QueryMatchResult, Verify, Cancel, DeleteFinger, QueryFingerStatus,
+		GetFingerCount, GetIdBitmap, Heartbeat, SetBaudRate, UpdateFeature,
+		GetSystemPolicy, SetSystemPolicy, EnterSleepMode, SetLEDControl>;
+
+#if defined(FPM383C_FULL_COMMAND_SET)
+	using Active = Full;
+#else
+	using Active = DoorOpener;
+#endif
+}
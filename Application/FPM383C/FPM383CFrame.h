@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+
+/**
+ * @brief FPM383C 命令帧的编译期生成工具
+ * @details 负载固定的命令 (心跳、查询手指状态等) 对给定密码总是产生相同的字节，
+ *          因此在编译期生成完整帧并存放于 Flash，运行时可直接由 DMA 发送，无需拷贝和计算校验和
+ *          负载可变的命令使用编译期生成的固定前缀 (链路层 + 密码 + 命令码)，运行时只需追加负载和应用层校验和
+ *
+ *          帧结构参考 FPM383C 用户手册 V1.2.0:
+ *          [0-7]:  帧头 (固定: F1 1F E2 2E B6 6B A8 8A)
+ *          [8-9]:  应用层数据长度 (big-endian, uint16)
+ *          [10]:   链路层校验和
+ *          [11-14]: 通信密码 (big-endian, uint32)
+ *          [15-16]: 命令码 (big-endian, uint16)
+ *          [17-N]:  命令负载 (可选)
+ *          [N+1]:   应用层校验和
+ */
+namespace FPM383CFrame {
+	inline constexpr std::array<uint8_t, 8> HEADER = { 0xF1, 0x1F, 0xE2, 0x2E, 0xB6, 0x6B, 0xA8, 0x8A };
+	inline constexpr size_t LINK_LAYER_LEN = 11;    // 帧头(8) + 长度(2) + 校验和(1)
+	inline constexpr size_t APP_PREFIX_LEN = 6;     // 密码(4) + 命令(2)
+	inline constexpr size_t PREFIX_LEN = LINK_LAYER_LEN + APP_PREFIX_LEN;
+
+	// 校验和计算: 取反加一
+	inline constexpr uint8_t Checksum(std::span<const uint8_t> data) {
+		uint8_t sum = std::accumulate(data.begin(), data.end(), static_cast<uint8_t>(0));
+		return ~sum + 1;
+	}
+
+	// 给定负载长度的完整帧长度
+	inline constexpr size_t FrameSize(size_t payloadLen) {
+		return PREFIX_LEN + payloadLen + 1;
+	}
+
+	/**
+	 * @brief 生成固定前缀: 链路层 (含校验和) + 密码 + 命令码
+	 * @tparam Command 命令码
+	 * @tparam PayloadLen 负载长度 (决定链路层中的应用层数据长度)
+	 * @tparam Password 通信密码
+	 */
+	template <uint16_t Command, size_t PayloadLen, uint32_t Password>
+	inline constexpr std::array<uint8_t, PREFIX_LEN> MakePrefix() {
+		constexpr uint16_t appDataLen = APP_PREFIX_LEN + PayloadLen + 1;
+
+		std::array<uint8_t, PREFIX_LEN> prefix{};
+		std::copy(HEADER.begin(), HEADER.end(), prefix.begin());
+		prefix[8] = static_cast<uint8_t>(appDataLen >> 8);
+		prefix[9] = static_cast<uint8_t>(appDataLen & 0xFF);
+		prefix[10] = Checksum({ prefix.data(), 10 });
+		prefix[11] = static_cast<uint8_t>(Password >> 24);
+		prefix[12] = static_cast<uint8_t>(Password >> 16);
+		prefix[13] = static_cast<uint8_t>(Password >> 8);
+		prefix[14] = static_cast<uint8_t>(Password & 0xFF);
+		prefix[15] = static_cast<uint8_t>(Command >> 8);
+		prefix[16] = static_cast<uint8_t>(Command & 0xFF);
+		return prefix;
+	}
+
+	/**
+	 * @brief 负载可变命令的固定前缀模板
+	 * @details 前缀和应用层前缀部分的累加和均在编译期确定，运行时只需拷贝前缀、追加负载并计算负载部分的校验和
+	 */
+	template <uint16_t Command, size_t PayloadLen, uint32_t Password>
+	struct Prefix {
+		static constexpr std::array<uint8_t, PREFIX_LEN> Bytes = MakePrefix<Command, PayloadLen, Password>();
+
+		// 应用层前缀 (密码 + 命令码) 的累加和
+		static constexpr uint8_t AppSum = std::accumulate(Bytes.begin() + LINK_LAYER_LEN, Bytes.end(), static_cast<uint8_t>(0));
+
+		static constexpr size_t Size = FrameSize(PayloadLen);
+
+		/**
+		 * @brief 在缓冲区中写入完整帧
+		 * @param buffer 目标缓冲区，至少 Size 字节
+		 * @param payload 命令负载
+		 * @return 帧长度
+		 */
+		static size_t Write(std::span<uint8_t> buffer, std::span<const uint8_t, PayloadLen> payload) {
+			auto it = std::copy(Bytes.begin(), Bytes.end(), buffer.begin());
+			it = std::copy(payload.begin(), payload.end(), it);
+			const uint8_t sum = std::accumulate(payload.begin(), payload.end(), AppSum);
+			*it = ~sum + 1;
+			return Size;
+		}
+	};
+
+	/**
+	 * @brief 生成负载固定的完整命令帧
+	 * @tparam Command 命令码
+	 * @tparam Password 通信密码
+	 * @tparam Payload 固定负载字节
+	 */
+	template <uint16_t Command, uint32_t Password, uint8_t... Payload>
+	inline constexpr std::array<uint8_t, FrameSize(sizeof...(Payload))> MakeFrame() {
+		constexpr auto prefix = MakePrefix<Command, sizeof...(Payload), Password>();
+		constexpr std::array<uint8_t, sizeof...(Payload)> payload = { Payload... };
+
+		std::array<uint8_t, FrameSize(sizeof...(Payload))> frame{};
+		auto it = std::copy(prefix.begin(), prefix.end(), frame.begin());
+		it = std::copy(payload.begin(), payload.end(), it);
+		*it = Checksum({ frame.data() + LINK_LAYER_LEN, APP_PREFIX_LEN + payload.size() });
+		return frame;
+	}
+
+	// 负载固定的完整命令帧，存放于 Flash (.rodata)
+	template <uint16_t Command, uint32_t Password, uint8_t... Payload>
+	inline constexpr auto Frame = MakeFrame<Command, Password, Payload...>();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "FPM383C.h"
+
+#if defined(USE_HAL_DRIVER)
+
+/**
+ * @brief UART 实例到 FPM383C 驱动的常数时间映射
+ * @details - STM32F1 的 USART1 ~ UART5 位于 1KB 对齐的外设地址 (0x40013800、0x40004400 ~ 0x40005000)，
+ *            地址第 10 ~ 14 位互不相同，直接作为 32 项表的下标
+ *          - 查找只需一次移位、一次与运算和一次访存，与注册的驱动数量无关，可在 ISR 中调用
+ *          - 注册应在对应 UART 开始接收之前完成，未注册的实例分发时被忽略
+ */
+class FPM383CRegistry {
+public:
+	static constexpr size_t TABLE_SIZE = 32;
+
+	/**
+	 * @brief 注册驱动，以其 UART 实例为键
+	 * @param driver 驱动实例
+	 * @return false 表示该表项已被另一个驱动占用
+	 */
+	inline bool Register(FPM383C &driver) {
+		FPM383C *&slot = _table[_indexOf(driver.GetUartHandle()->Instance)];
+		if (slot != nullptr && slot != &driver) {
+			return false;
+		}
+		slot = &driver;
+		return true;
+	}
+
+	/**
+	 * @brief 查找 UART 对应的驱动
+	 * @return 驱动实例，未注册时为 nullptr
+	 */
+	inline FPM383C *Find(const UART_HandleTypeDef *huart) const {
+		FPM383C *driver = _table[_indexOf(huart->Instance)];
+		// 表项只按地址位区分，确认实例一致，防止未注册的实例落在已注册实例的表项上
+		return driver != nullptr && driver->GetUartHandle()->Instance == huart->Instance ? driver : nullptr;
+	}
+
+	/**
+	 * @brief 将 UART 接收事件分发给对应的驱动
+	 * @return 是否找到驱动
+	 */
+	inline bool DispatchRxEvent(const UART_HandleTypeDef *huart, uint16_t size) const {
+		FPM383C *driver = Find(huart);
+		if (driver == nullptr) {
+			return false;
+		}
+		driver->UartRxCallback(size);
+		return true;
+	}
+
+	/**
+	 * @brief 将 UART 错误分发给对应的驱动
+	 * @return 是否找到驱动
+	 */
+	inline bool DispatchError(const UART_HandleTypeDef *huart) const {
+		FPM383C *driver = Find(huart);
+		if (driver == nullptr) {
+			return false;
+		}
+		driver->UartErrorCallback();
+		return true;
+	}
+
+private:
+	static inline size_t _indexOf(const USART_TypeDef *instance) {
+		return (reinterpret_cast<uintptr_t>(instance) >> 10) & (TABLE_SIZE - 1);
+	}
+
+	std::array<FPM383C *, TABLE_SIZE> _table{};
+};
+
+#endif
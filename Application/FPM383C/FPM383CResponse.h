@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+
+/**
+ * @brief FPM383C 响应负载的编译期解码工具
+ * @details 每条命令的响应负载以字段列表声明 (偏移 + 类型，均为 big-endian)，
+ *          由此在编译期生成解码函数和最小长度检查，展开后与手写的移位或运算相同，没有运行时开销
+ *
+ *          示例: using CountLayout = Layout<Field<uint16_t, 0>>;
+ *                if (auto fields = CountLayout::Decode(response)) { auto [count] = *fields; }
+ */
+namespace FPM383CResponse {
+	/**
+	 * @brief 位于负载 Offset 处的 big-endian 字段
+	 * @tparam T 字段类型 (无符号整数或枚举)
+	 * @tparam Offset 字段在负载中的偏移
+	 * @tparam Size 字段占用的字节数，默认为 sizeof(T)
+	 */
+	template <typename T, size_t Offset, size_t Size = sizeof(T)>
+	struct Field {
+		static_assert(Size > 0 && Size <= sizeof(uint32_t), "Field must be 1 to 4 bytes");
+
+		using Type = T;
+		static constexpr size_t OFFSET = Offset;
+		static constexpr size_t END = Offset + Size;
+
+		// 读取字段，调用方保证 data.size() >= END
+		static constexpr T Read(std::span<const uint8_t> data) {
+			uint32_t value = 0;
+			for (size_t i = 0; i < Size; i++) {
+				value = (value << 8) | data[Offset + i];
+			}
+			return static_cast<T>(value);
+		}
+	};
+
+	/**
+	 * @brief 由字段列表构成的响应负载布局
+	 * @details MIN_SIZE 由字段推导，Decode 在长度不足时返回空，否则按声明顺序返回所有字段
+	 */
+	template <typename... Fields>
+	struct Layout {
+		static constexpr size_t MIN_SIZE = std::max({ size_t{ 0 }, Fields::END... });
+
+		using Values = std::tuple<typename Fields::Type...>;
+
+		static constexpr bool Fits(std::span<const uint8_t> data) {
+			return data.size() >= MIN_SIZE;
+		}
+
+		static constexpr std::optional<Values> Decode(std::span<const uint8_t> data) {
+			if (!Fits(data)) {
+				return std::nullopt;
+			}
+			return Values{ Fields::Read(data)... };
+		}
+	};
+
+	// --- 各命令的响应布局 (参考 FPM383C 用户手册 V1.2.0) ---
+
+	// 链路层头: 帧头(8) + 应用层数据长度(2)
+	using LinkHeaderLayout = Layout<Field<uint16_t, 8>>;
+
+	// 应用层数据 (不含校验和): 密码(4) + 应答命令码(2) + 错误码(4)
+	using AppHeaderLayout = Layout<Field<uint16_t, 4>, Field<uint32_t, 6>>;
+
+	// 查询手指在位状态: 状态(1)，1 = 按下
+	using FingerStatusLayout = Layout<Field<uint8_t, 0>>;
+
+	// 同步匹配与查询匹配结果: 结果(2，1 = 成功) + 分数(2) + ID(2)
+	using MatchLayout = Layout<Field<uint16_t, 0>, Field<uint16_t, 2>, Field<uint16_t, 4>>;
+
+	// 自动注册进度: 步骤(1，0xFF = 完成) + ID(2) + 保留(1) + 进度(1)
+	using EnrollProgressLayout = Layout<Field<uint8_t, 0>, Field<uint16_t, 1>, Field<uint8_t, 4>>;
+
+	// 获取指纹数量: 数量(2)
+	using FingerCountLayout = Layout<Field<uint16_t, 0>>;
+
+	// 获取系统策略: 策略(4)，策略位位于最低字节
+	using SystemPolicyLayout = Layout<Field<uint32_t, 0>>;
+
+	// 开始上传模板: 模板大小(2)
+	using UploadTemplateStartLayout = Layout<Field<uint16_t, 0>>;
+
+	// 上传模板数据: 块序号(2) + 数据
+	using UploadTemplateDataLayout = Layout<Field<uint16_t, 0>>;
+
+	static_assert(AppHeaderLayout::MIN_SIZE == 10);
+	static_assert(MatchLayout::MIN_SIZE == 6);
+	static_assert(EnrollProgressLayout::MIN_SIZE == 5);
+}
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "FPM383C.h"
+#include "FPM383CRegistry.h"
 
 #include "Button_Shared.h"
 
-// 指纹模块全局实例
+// 指纹模块全局实例 (门内侧，USART2)
+// 本板没有控制模块电源的 GPIO，因此不传入 powerPin:
+// Init() 不做上电探测，Recover() 最高只升级到 Resync，PowerCycle 级别不可用
 inline FPM383C fpm383c(&huart2, fingerprintTouchButtonPair);
+
+// UART 实例到指纹模块驱动的映射，UART 回调通过它分发到对应的驱动
+// 双面门的室外模块在 CubeMX 中配置好 UART 后在此追加实例，并在 FPM383CTask 中加入传感器列表
+inline FPM383CRegistry fpm383cRegistry;
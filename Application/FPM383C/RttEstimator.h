@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief 往返时间估计器 (Jacobson/Karels 算法，与 TCP 重传超时的计算方式相同)
+ * @details SRTT   = 7/8 * SRTT + 1/8 * R
+ *          RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|
+ *          RTO    = SRTT + 4 * RTTVAR
+ *          以定点数保存 SRTT x8 和 RTTVAR x4，更新只需移位和加减，可在中断中调用
+ */
+class RttEstimator {
+public:
+	/**
+	 * @brief 加入一个往返时间样本
+	 * @param rttMs 从发出命令到收到完整响应的时间 (毫秒)
+	 */
+	inline void AddSample(uint32_t rttMs) {
+		if (!_hasSample) {
+			// 第一个样本: SRTT = R, RTTVAR = R / 2
+			_srtt8 = rttMs << 3;
+			_rttvar4 = rttMs << 1;
+			_hasSample = true;
+			return;
+		}
+
+		int32_t delta = static_cast<int32_t>(rttMs) - static_cast<int32_t>(_srtt8 >> 3);
+		_srtt8 += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+		_rttvar4 += delta - static_cast<int32_t>(_rttvar4 >> 2);
+	}
+
+	/**
+	 * @brief 根据当前估计计算超时时间
+	 * @param floorMs 超时下限
+	 * @param ceilingMs 超时上限，没有样本时直接使用
+	 * @return 超时时间 (毫秒)
+	 */
+	inline uint32_t GetTimeout(uint32_t floorMs, uint32_t ceilingMs) const {
+		if (!_hasSample) {
+			return ceilingMs;
+		}
+		return std::clamp<uint32_t>((_srtt8 >> 3) + _rttvar4, floorMs, ceilingMs);
+	}
+
+	// 平滑后的往返时间 (毫秒)
+	inline uint32_t GetSmoothedRtt() const { return _srtt8 >> 3; }
+
+	// 往返时间的平均偏差 (毫秒)
+	inline uint32_t GetRttVariation() const { return _rttvar4 >> 2; }
+
+	inline bool HasSample() const { return _hasSample; }
+
+	inline void Reset() { *this = {}; }
+
+private:
+	uint32_t _srtt8 = 0;   // SRTT x8
+	uint32_t _rttvar4 = 0; // RTTVAR x4
+	bool _hasSample = false;
+};
@@ -0,0 +1,124 @@
+#include "FPM383CService.h"
+
+#include <algorithm> // 用于 std::min
+#include <utility>   // 用于 std::move
+
+bool FPM383CService::Init() {
+	if (_owner != nullptr) {
+		return true;
+	}
+
+	const osMessageQueueAttr_t unlockAttributes = {
+		.name = "FPMUnlockQueue",
+		.cb_mem = &_unlockQueueControlBlock,
+		.cb_size = sizeof(_unlockQueueControlBlock),
+		.mq_mem = _unlockQueueBuffer.data(),
+		.mq_size = sizeof(_unlockQueueBuffer)
+	};
+	const osMessageQueueAttr_t housekeepingAttributes = {
+		.name = "FPMHousekeepingQueue",
+		.cb_mem = &_housekeepingQueueControlBlock,
+		.cb_size = sizeof(_housekeepingQueueControlBlock),
+		.mq_mem = _housekeepingQueueBuffer.data(),
+		.mq_size = sizeof(_housekeepingQueueBuffer)
+	};
+	_unlockQueue = osMessageQueueNew(QUEUE_LENGTH, sizeof(Request *), &unlockAttributes);
+	_housekeepingQueue = osMessageQueueNew(QUEUE_LENGTH, sizeof(Request *), &housekeepingAttributes);
+	if (_unlockQueue == nullptr || _housekeepingQueue == nullptr) {
+		return false;
+	}
+	// 协程就绪时唤醒所有者任务，由 WaitAndProcess() 恢复
+	if (!_executor.Init([this] { Wake(); })) {
+		return false;
+	}
+
+	// 最后登记所有者，其他任务看到所有者时邮箱一定已经可用
+	_owner = osThreadGetId();
+	return true;
+}
+
+FPM383C::CommandResult FPM383CService::Call(const Operation &op, Priority priority/* = Priority::Housekeeping*/,
+	uint32_t timeout/* = osWaitForever*/) {
+	return Call(_driver, op, priority, timeout);
+}
+
+FPM383C::CommandResult FPM383CService::Call(FPM383C &driver, const Operation &op, Priority priority/* = Priority::Housekeeping*/,
+	uint32_t timeout/* = osWaitForever*/) {
+	if (_owner == nullptr || !op) {
+		return { FPM383C::Status::UnknownError, FPM383C::ModuleErrorCode::None };
+	}
+
+	const osThreadId_t self = osThreadGetId();
+	if (self == _owner) {
+		// 所有者任务自身的调用直接执行，避免等待自己
+		return op(driver);
+	}
+
+	Request request{ .Op = op, .Driver = &driver, .Requester = self };
+	osThreadFlagsClear(COMPLETION_FLAG);
+	Request *pointer = &request;
+	const osMessageQueueId_t queue = priority == Priority::Unlock ? _unlockQueue : _housekeepingQueue;
+	if (osMessageQueuePut(queue, &pointer, 0, timeout) != osOK) {
+		return { FPM383C::Status::Busy, FPM383C::ModuleErrorCode::None };
+	}
+	osThreadFlagsSet(_owner, REQUEST_FLAG);
+
+	// 请求位于本任务栈上，必须等到所有者执行完毕
+	osThreadFlagsWait(COMPLETION_FLAG, osFlagsWaitAny, osWaitForever);
+	return request.Result;
+}
+
+bool FPM383CService::Post(Request &request, Priority priority) {
+	if (_owner == nullptr || !request.Op) {
+		return false;
+	}
+
+	Request *pointer = &request;
+	const osMessageQueueId_t queue = priority == Priority::Unlock ? _unlockQueue : _housekeepingQueue;
+	// 超时为 0，可在 ISR 中调用
+	if (osMessageQueuePut(queue, &pointer, 0, 0) != osOK) {
+		return false;
+	}
+	osThreadFlagsSet(_owner, REQUEST_FLAG);
+	return true;
+}
+
+bool FPM383CService::Spawn(CoTask<void> &&task) {
+	if (osThreadGetId() != _owner) {
+		return false;
+	}
+	return _executor.Spawn(std::move(task));
+}
+
+void FPM383CService::Wake() {
+	if (_owner != nullptr) {
+		osThreadFlagsSet(_owner, REQUEST_FLAG);
+	}
+}
+
+uint32_t FPM383CService::WaitAndProcess(uint32_t timeout) {
+	// 先运行就绪的协程，最多等到最早的休眠协程到期
+	timeout = std::min(timeout, _executor.RunReady());
+	osThreadFlagsWait(REQUEST_FLAG, osFlagsWaitAny, timeout);
+
+	uint32_t processed = 0;
+	while (Request *request = _takeNext()) {
+		request->Result = request->Op(request->Driver != nullptr ? *request->Driver : _driver);
+		if (request->Requester != nullptr) {
+			osThreadFlagsSet(request->Requester, COMPLETION_FLAG);
+		}
+		processed++;
+	}
+	return processed;
+}
+
+FPM383CService::Request *FPM383CService::_takeNext() {
+	Request *request = nullptr;
+	if (osMessageQueueGet(_unlockQueue, &request, nullptr, 0) == osOK) {
+		return request;
+	}
+	if (osMessageQueueGet(_housekeepingQueue, &request, nullptr, 0) == osOK) {
+		return request;
+	}
+	return nullptr;
+}
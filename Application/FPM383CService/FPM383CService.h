@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "cmsis_os.h"
+
+#include "CoExecutor.h"
+#include "Delegate.h"
+#include "FPM383C.h"
+
+/**
+ * @brief FPM383C 驱动的所有者服务
+ * @details - 驱动本身不加锁，所有对模块的访问都必须在所有者任务 (FPM383CTask) 中执行
+ *          - 其他任务通过 Call() 提交请求，请求进入静态分配的两级邮箱，由所有者任务依次执行后唤醒请求方
+ *          - 开门路径 (Unlock) 的请求总是先于维护 (Housekeeping) 请求执行；
+ *            正在执行的请求不会被打断，因此维护请求应保持简短
+ *          - 请求对象由请求方持有，完成前必须保持有效
+ *          - 一个所有者任务可服务多个模块，请求通过 Driver 指定目标模块，默认为构造时给出的模块
+ *          - 所有者任务同时驱动协程执行器: 由 Spawn() 托管的协程在 WaitAndProcess() 中恢复，
+ *            因此协程中可以直接 co_await 驱动的可等待操作 (如 co_await fpm383c.MatchAsync())，不阻塞所有者任务
+ */
+class FPM383CService {
+public:
+	// 请求优先级
+	enum class Priority : uint8_t {
+		Unlock,       // 开门路径，如触摸后的匹配
+		Housekeeping  // 维护操作，如注册、删除、查询
+	};
+
+	// 在所有者任务中对驱动执行的操作，捕获不得超过 Operation::CAPACITY 字节
+	using Operation = Delegate<FPM383C::CommandResult(FPM383C &)>;
+
+	// 一次请求
+	struct Request {
+		Operation Op;                                                                   // 要执行的操作
+		FPM383C *Driver = nullptr;                                                       // 目标模块，为空时使用默认模块
+		FPM383C::CommandResult Result{ FPM383C::Status::UnknownError, FPM383C::ModuleErrorCode::None }; // 执行结果
+		osThreadId_t Requester = nullptr;                                                // 完成后唤醒的任务，为空时不通知
+	};
+
+	static constexpr uint32_t QUEUE_LENGTH = 4;          // 每个优先级的邮箱长度
+	static constexpr uint32_t REQUEST_FLAG = 0x0800;     // 所有者任务的新请求线程标志
+	static constexpr uint32_t COMPLETION_FLAG = 0x0400;  // 请求方的请求完成线程标志
+
+	FPM383CService(FPM383C &driver, CoExecutor &executor) : _driver(driver), _executor(executor) { }
+
+	/**
+	 * @brief 创建邮箱和协程执行器的就绪队列，并将当前任务登记为驱动的所有者，必须在所有者任务中调用
+	 * @return 是否初始化成功
+	 */
+	bool Init();
+
+	/**
+	 * @brief 提交请求并阻塞等待完成
+	 * @details 在所有者任务中调用时直接执行；邮箱已满或服务未初始化时返回 Busy / UnknownError
+	 * @param op 要执行的操作
+	 * @param priority 请求优先级
+	 * @param timeout 等待邮箱空位的时间 (毫秒)，请求一旦提交就会等待其完成
+	 * @return 操作的执行结果
+	 */
+	FPM383C::CommandResult Call(const Operation &op, Priority priority = Priority::Housekeeping, uint32_t timeout = osWaitForever);
+
+	/**
+	 * @brief 对指定模块提交请求并阻塞等待完成
+	 * @param driver 目标模块
+	 */
+	FPM383C::CommandResult Call(FPM383C &driver, const Operation &op, Priority priority = Priority::Housekeeping,
+		uint32_t timeout = osWaitForever);
+
+	/**
+	 * @brief 提交请求但不等待 (ISR 安全)
+	 * @param request 请求，完成前必须保持有效；Requester 不为空时完成后向其发送 COMPLETION_FLAG
+	 * @param priority 请求优先级
+	 * @return 是否提交成功
+	 */
+	bool Post(Request &request, Priority priority);
+
+	/**
+	 * @brief 在所有者任务中托管一个协程，协程在 WaitAndProcess() 中开始执行
+	 * @details 必须在所有者任务中调用 (例如在 Call() 或 Post() 的操作中)，协程帧从 CoroutineArena 分配
+	 * @param task 协程任务
+	 * @return false 表示协程帧分配失败或就绪队列已满
+	 */
+	bool Spawn(CoTask<void> &&task);
+
+	/**
+	 * @brief 所有者任务中的协程执行器
+	 */
+	CoExecutor &GetExecutor() { return _executor; }
+
+	/**
+	 * @brief 唤醒所有者任务 (ISR 安全)
+	 * @details 用作驱动的完成通知，所有者任务从 WaitAndProcess() 返回后分发驱动的完成队列
+	 */
+	void Wake();
+
+	/**
+	 * @brief 运行就绪的协程，等待新请求并执行所有待处理的请求，在所有者任务中调用
+	 * @param timeout 没有请求时等待的时间 (毫秒)，不会超过最近一个休眠协程的到期时间
+	 * @return 执行的请求数量
+	 */
+	uint32_t WaitAndProcess(uint32_t timeout);
+
+private:
+	// 取出下一条请求，开门路径优先
+	Request *_takeNext();
+
+	FPM383C &_driver;
+	CoExecutor &_executor;
+	osThreadId_t _owner = nullptr;
+
+	osMessageQueueId_t _unlockQueue = nullptr;
+	StaticQueue_t _unlockQueueControlBlock{};
+	std::array<Request *, QUEUE_LENGTH> _unlockQueueBuffer{};
+
+	osMessageQueueId_t _housekeepingQueue = nullptr;
+	StaticQueue_t _housekeepingQueueControlBlock{};
+	std::array<Request *, QUEUE_LENGTH> _housekeepingQueueBuffer{};
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "CoExecutor_Shared.h"
+#include "FPM383CService.h"
+#include "FPM383C_Shared.h"
+
+// 指纹模块所有者服务全局实例，其他任务通过它访问 fpm383c，所有者任务同时驱动 coExecutor 中的协程
+inline FPM383CService fpm383cService(fpm383c, coExecutor);
@@ -0,0 +1,181 @@
+#include "FingerprintIndex.h"
+
+#include <algorithm> // 用于 std::copy
+#include <bit>       // 用于 std::popcount, std::countr_one
+#include <limits>    // 用于 std::numeric_limits
+
+FingerprintIndex::Status FingerprintIndex::Load() {
+	const uint32_t address = _findLatestBlock();
+	if (address == 0 || address == std::numeric_limits<uint32_t>::max()) {
+		_bitmap = {};
+		_entries = {};
+		_count = 0;
+		// 页面内容异常 (如写入中途掉电) 时让下次写入先擦除
+		_lastBlockAddress = address == 0 ? PAGE_ADDRESS + FLASH_PAGE_SIZE_CONST : PAGE_ADDRESS;
+		return Status::DataNotFound;
+	}
+
+	const auto *block = reinterpret_cast<const Block *>(address);
+	_bitmap = block->Bitmap;
+	_entries = block->Entries;
+	_count = 0;
+	for (uint32_t word : _bitmap) {
+		_count += std::popcount(word);
+	}
+	_lastBlockAddress = address;
+	return Status::Ok;
+}
+
+FingerprintIndex::Status FingerprintIndex::Reconcile(FPM383C &driver) {
+	std::array<uint8_t, CAPACITY / 8> moduleBitmap;
+	auto [status, errCode] = driver.GetIdBitmap(moduleBitmap);
+	if (status != FPM383C::Status::OK) {
+		// 模块不支持读取位图，退回比较数量
+		uint16_t moduleCount = 0;
+		auto [countStatus, countErrCode] = driver.GetFingerprintCount(moduleCount);
+		_isReconciled = countStatus == FPM383C::Status::OK && moduleCount == _count;
+		return countStatus == FPM383C::Status::OK ? Status::Ok : Status::ModuleError;
+	}
+
+	bool isChanged = false;
+	for (uint16_t id = 0; id < CAPACITY; id++) {
+		const bool isOnModule = (moduleBitmap[id / 8] & (1u << (id % 8))) != 0;
+		if (isOnModule == IsEnrolled(id)) {
+			continue;
+		}
+		// 以模块为准: 模块中已不存在的 ID 丢弃元数据，本地缺失的 ID 记为未关联用户
+		_set(id, isOnModule);
+		_entries[id] = {};
+		isChanged = true;
+	}
+
+	_isReconciled = true;
+	return isChanged ? _save() : Status::Ok;
+}
+
+uint16_t FingerprintIndex::AllocateId() const {
+	if (!_isReconciled) {
+		return INVALID_ID;
+	}
+	for (size_t i = 0; i < BITMAP_WORDS; i++) {
+		if (_bitmap[i] != std::numeric_limits<uint32_t>::max()) {
+			return static_cast<uint16_t>(i * 32 + std::countr_one(_bitmap[i]));
+		}
+	}
+	return INVALID_ID;
+}
+
+FingerprintIndex::Status FingerprintIndex::Record(uint16_t id, const Metadata &metadata) {
+	if (id >= CAPACITY) {
+		return Status::InvalidId;
+	}
+	_set(id, true);
+	_entries[id] = metadata;
+	return _save();
+}
+
+FingerprintIndex::Status FingerprintIndex::Remove(uint16_t id) {
+	if (id >= CAPACITY) {
+		return Status::InvalidId;
+	}
+	if (!IsEnrolled(id)) {
+		return Status::NotFound;
+	}
+	_set(id, false);
+	_entries[id] = {};
+	return _save();
+}
+
+FingerprintIndex::Status FingerprintIndex::Clear() {
+	_bitmap = {};
+	_entries = {};
+	_count = 0;
+	return _save();
+}
+
+// --- 私有方法 ---
+
+void FingerprintIndex::_set(uint16_t id, bool isEnrolled) {
+	const uint32_t mask = 1u << (id % 32);
+	uint32_t &word = _bitmap[id / 32];
+	if (((word & mask) != 0) == isEnrolled) {
+		return;
+	}
+	if (isEnrolled) {
+		word |= mask;
+		_count++;
+	} else {
+		word &= ~mask;
+		_count--;
+	}
+}
+
+FingerprintIndex::Status FingerprintIndex::_save() {
+	const Block block{
+		.Magic = MAGIC_HEADER,
+		.Reserved = 0xFFFF,
+		.Bitmap = _bitmap,
+		.Entries = _entries
+	};
+
+	uint32_t writeAddress = _lastBlockAddress - sizeof(Block);
+	if (_lastBlockAddress < PAGE_ADDRESS + sizeof(Block)) {
+		// 空间不足，擦除后写入页尾
+		const Status eraseStatus = _erasePage();
+		if (eraseStatus != Status::Ok) {
+			return eraseStatus;
+		}
+		writeAddress = PAGE_ADDRESS + FLASH_PAGE_SIZE_CONST - sizeof(Block);
+	}
+
+	const Status writeStatus = _writeToFlash(writeAddress, reinterpret_cast<const uint8_t *>(&block), sizeof(Block));
+	if (writeStatus == Status::Ok) {
+		_lastBlockAddress = writeAddress;
+	}
+	return writeStatus;
+}
+
+uint32_t FingerprintIndex::_findLatestBlock() const {
+	// 由于反向写入，从页首开始找到的第一个魔术字就是最新的数据块
+	for (uint32_t addr = PAGE_ADDRESS; addr + sizeof(Block) <= PAGE_ADDRESS + FLASH_PAGE_SIZE_CONST; addr += 4) {
+		const uint16_t content = *reinterpret_cast<const volatile uint16_t *>(addr);
+		if (content == MAGIC_HEADER) {
+			return addr;
+		}
+		if (content != std::numeric_limits<uint16_t>::max()) {
+			return std::numeric_limits<uint32_t>::max(); // 页面内容异常
+		}
+	}
+	return 0;
+}
+
+FingerprintIndex::Status FingerprintIndex::_erasePage() {
+	FLASH_EraseInitTypeDef eraseInitStruct;
+	uint32_t pageError = 0;
+
+	eraseInitStruct.TypeErase = FLASH_TYPEERASE_PAGES;
+	eraseInitStruct.PageAddress = PAGE_ADDRESS;
+	eraseInitStruct.NbPages = 1;
+
+	HAL_FLASH_Unlock();
+	const HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&eraseInitStruct, &pageError);
+	HAL_FLASH_Lock();
+
+	return (status == HAL_OK && pageError == std::numeric_limits<uint32_t>::max()) ? Status::Ok : Status::FlashEraseError;
+}
+
+FingerprintIndex::Status FingerprintIndex::_writeToFlash(uint32_t address, const uint8_t *data, uint32_t sizeInBytes) {
+	HAL_StatusTypeDef status = HAL_OK;
+
+	HAL_FLASH_Unlock();
+	for (uint32_t i = 0; i < sizeInBytes; i += 4) {
+		const uint32_t word = *reinterpret_cast<const uint32_t *>(data + i);
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + i, word);
+		if (status != HAL_OK) {
+			break;
+		}
+	}
+	HAL_FLASH_Lock();
+
+	return (status == HAL_OK) ? Status::Ok : Status::FlashWriteError;
+}
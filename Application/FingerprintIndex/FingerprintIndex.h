@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "stm32f1xx_hal.h" // 用于 Flash 宏
+
+#include "FPM383C.h"
+
+/**
+ * @class FingerprintIndex
+ * @brief 指纹 ID 占用位图和每个 ID 的元数据 (用户) 的本地缓存
+ *
+ * - ID 分配、数量统计、ID 有效性检查和 ID 到用户的查找都在 RAM 中以 O(1) 完成，无需与模块往返
+ * - 数据保存在倒数第二个 Flash 页 (最后一页属于 FlashConfig)，与 FlashConfig 相同，
+ *   新块从页尾向前顺序写入，页写满后才擦除
+ * - 启动时与模块核对: 以模块的 ID 位图为准，丢弃模块中已不存在的 ID 的元数据
+ */
+class FingerprintIndex {
+public:
+	static constexpr uint16_t CAPACITY = 64;          // 可记录的 ID 数量 (FPM383C 最多 60 枚指纹)
+	static constexpr uint16_t INVALID_ID = 0xFFFF;    // 无可用 ID，同时也是模块自动分配 ID 的取值
+	static constexpr uint16_t UNKNOWN_USER = 0xFFFF;  // 未关联用户
+
+	/**
+	 * @brief 每个 ID 的元数据，4 字节
+	 */
+	struct Metadata {
+		uint16_t UserId = UNKNOWN_USER;  // 所属用户
+		uint8_t Flags = 0;               // 用户自定义标志 (如管理员)
+		uint8_t Reserved = 0xFF;
+	};
+
+	/**
+	 * @brief 操作的状态码枚举
+	 */
+	enum class Status : uint8_t {
+		Ok,               // 操作成功
+		InvalidId,        // ID 超出范围
+		NotFound,         // ID 未注册
+		FlashWriteError,  // HAL 写入操作失败
+		FlashEraseError,  // HAL 擦除操作失败
+		DataNotFound,     // Flash 中没有有效的数据块
+		ModuleError       // 与模块核对失败
+	};
+
+private:
+	// --- 编译期 Flash 几何信息配置 ---
+
+	// 用于存储的 Flash 页面（从内存末尾倒数），最后一页由 FlashConfig 使用
+	static constexpr uint32_t PAGE_OFFSET_FROM_END = 2;
+
+	static constexpr uint32_t FLASH_PAGE_SIZE_CONST = FLASH_PAGE_SIZE;
+	static constexpr uint32_t FLASH_END_ADDR_CONST = FLASH_BANK1_END;
+	static constexpr uint32_t PAGE_ADDRESS = (FLASH_END_ADDR_CONST + 1) - (PAGE_OFFSET_FROM_END * FLASH_PAGE_SIZE_CONST);
+
+	// 魔术字 "Fi"，用于标识一个数据块的开始
+	static constexpr uint16_t MAGIC_HEADER = 0x6946; // 'F' 'i'
+
+	static constexpr size_t BITMAP_WORDS = CAPACITY / 32;
+
+	// Flash 中的数据块: 魔术字(2) + 保留(2) + 位图 + 元数据表，4 字节对齐以便按字写入
+	struct Block {
+		uint16_t Magic;
+		uint16_t Reserved;
+		std::array<uint32_t, BITMAP_WORDS> Bitmap;
+		std::array<Metadata, CAPACITY> Entries;
+	};
+	static_assert(sizeof(Block) % 4 == 0, "Block must be word aligned for flash programming");
+	static_assert(sizeof(Block) <= FLASH_PAGE_SIZE, "Block must fit in one flash page");
+
+public:
+	/**
+	 * @brief 从 Flash 加载最新的数据块
+	 * @return Ok，或 DataNotFound (此时索引为空)
+	 */
+	Status Load();
+
+	/**
+	 * @brief 与模块核对 ID 占用情况，有变化时写回 Flash
+	 * @details 优先读取模块的 ID 位图；模块不支持时退回比较指纹数量，数量不一致则视为不可信，
+	 *          此时 AllocateId() 返回 INVALID_ID，由模块自动分配
+	 * @param driver 指纹模块驱动，必须在所有者任务中调用
+	 * @return 操作状态
+	 */
+	Status Reconcile(FPM383C &driver);
+
+	/**
+	 * @brief 本地索引是否已与模块一致
+	 */
+	bool IsReconciled() const { return _isReconciled; }
+
+	/**
+	 * @brief ID 是否已注册
+	 */
+	bool IsEnrolled(uint16_t id) const {
+		return id < CAPACITY && (_bitmap[id / 32] & (1u << (id % 32))) != 0;
+	}
+
+	/**
+	 * @brief 获取已注册的指纹数量
+	 */
+	uint16_t GetCount() const { return _count; }
+
+	/**
+	 * @brief 分配最小的空闲 ID
+	 * @return 空闲 ID，已满或索引不可信时返回 INVALID_ID (即让模块自动分配)
+	 */
+	uint16_t AllocateId() const;
+
+	/**
+	 * @brief 查找 ID 的元数据
+	 * @return 元数据，ID 未注册时为 nullptr
+	 */
+	const Metadata *Find(uint16_t id) const {
+		return IsEnrolled(id) ? &_entries[id] : nullptr;
+	}
+
+	/**
+	 * @brief 记录注册成功的 ID 并写入 Flash
+	 * @param id 模块返回的最终 ID
+	 * @param metadata 元数据
+	 * @return 操作状态
+	 */
+	Status Record(uint16_t id, const Metadata &metadata);
+
+	/**
+	 * @brief 移除已删除的 ID 并写入 Flash
+	 * @param id 已从模块删除的 ID
+	 * @return 操作状态
+	 */
+	Status Remove(uint16_t id);
+
+	/**
+	 * @brief 清空索引 (模块已删除所有指纹) 并写入 Flash
+	 * @return 操作状态
+	 */
+	Status Clear();
+
+private:
+	void _set(uint16_t id, bool isEnrolled);
+
+	/**
+	 * @brief 将当前索引写入 Flash，页面写满时先擦除
+	 */
+	Status _save();
+
+	/**
+	 * @brief 扫描页面，返回最新数据块的地址，未找到时返回 0，页面内容异常时返回 0xFFFFFFFF
+	 */
+	uint32_t _findLatestBlock() const;
+
+	Status _erasePage();
+	Status _writeToFlash(uint32_t address, const uint8_t *data, uint32_t sizeInBytes);
+
+	std::array<uint32_t, BITMAP_WORDS> _bitmap{};
+	std::array<Metadata, CAPACITY> _entries{};
+	uint16_t _count = 0;
+	bool _isReconciled = false;
+
+	// 上次写入的数据块地址，没有数据块时为页尾
+	uint32_t _lastBlockAddress = PAGE_ADDRESS + FLASH_PAGE_SIZE_CONST;
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "FingerprintIndex.h"
+
+// 门内侧指纹模块的 ID 索引
+inline FingerprintIndex fingerprintIndex;
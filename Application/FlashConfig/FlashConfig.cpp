@@ -118,6 +118,27 @@ uint16_t FlashConfig::GetValue(uint16_t key) const {
 	return INVALID_VALUE;
 }
 
+FlashConfig::Status FlashConfig::SetValue(uint16_t key, uint16_t value) {
+	std::array<Config, MAX_CONFIG_ITEMS> configs;
+	std::copy(_loadedConfig.begin(), _loadedConfig.begin() + _loadedCount, configs.begin());
+	uint16_t count = _loadedCount;
+
+	auto it = std::find_if(configs.begin(), configs.begin() + count, [key](const Config &config) { return config.key == key; });
+	if (it != configs.begin() + count) {
+		if (it->value == value) {
+			return Status::Ok; // 值未改变，无需写入
+		}
+		it->value = value;
+	} else {
+		if (count >= MAX_CONFIG_ITEMS) {
+			return Status::DataTooLarge;
+		}
+		configs[count++] = { key, value };
+	}
+
+	return WriteConfig({ configs.data(), count });
+}
+
 // --- 私有方法 ---
 
 uint32_t FlashConfig::_findLatestConfig() {
@@ -114,6 +114,17 @@ public:
 	 */
 	uint16_t GetValue(uint16_t key) const;
 
+	/**
+	 * @brief 修改（或新增）单个配置项并写入 Flash
+	 *
+	 * 以当前已加载的配置为基础写入完整的新配置块，值未改变时不写入，以免消耗擦写次数
+	 *
+	 * @param key 要修改的键
+	 * @param value 新值
+	 * @return 一个 Status 码，指示操作的结果
+	 */
+	Status SetValue(uint16_t key, uint16_t value);
+
 	/**
 	 * @brief 获取当前加载的配置项数量
 	 * @return 已加载项的数量
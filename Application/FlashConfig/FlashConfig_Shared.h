@@ -0,0 +1,11 @@
+#pragma once
+
+#include "FlashConfig.h"
+
+// 配置项的键
+namespace FlashConfigKey {
+	inline constexpr uint16_t FingerprintBaudRate = 0x0001; // 指纹模块波特率 (单位: 100 baud，值只有 16 位)
+}
+
+// Flash 配置全局实例
+inline FlashConfig flashConfig;
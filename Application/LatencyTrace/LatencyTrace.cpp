@@ -0,0 +1,139 @@
+#include "LatencyTrace.h"
+
+#include <algorithm>
+
+#include "stm32f1xx_hal.h"
+
+#include "strings.h"
+
+// 关闭中断并返回之前的 PRIMASK，EXTI、UART 回调和任务都会调用
+static inline uint32_t trace_enter_critical() {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+static inline void trace_exit_critical(uint32_t primask) {
+	__set_PRIMASK(primask);
+}
+
+// 从 start 到现在经过的微秒数
+static inline uint32_t elapsed_us(uint32_t startCycle) {
+	return (DWT->CYCCNT - startCycle) / (SystemCoreClock / 1000000);
+}
+
+void LatencyTrace::Init() {
+	CoreDebug->DEMCR = CoreDebug->DEMCR | CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL = DWT->CTRL | DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void LatencyTrace::BeginAttempt() {
+	const uint32_t state = trace_enter_critical();
+	if (_isAttemptOpen && elapsed_us(_recordAt(_recordCount - 1).StartCycle) < ATTEMPT_TIMEOUT_US) {
+		trace_exit_critical(state);
+		return;
+	}
+
+	Record &record = _records[_nextIndex];
+	record.StartCycle = DWT->CYCCNT;
+	record.OffsetUs = MakeEmptyOffsets();
+	record.OffsetUs[static_cast<size_t>(Phase::Touch)] = 0;
+
+	_nextIndex = (_nextIndex + 1) % RECORD_COUNT;
+	_recordCount = std::min(_recordCount + 1, RECORD_COUNT);
+	_isAttemptOpen = true;
+	trace_exit_critical(state);
+}
+
+void LatencyTrace::Mark(Phase phase) {
+	const uint32_t state = trace_enter_critical();
+	if (_isAttemptOpen) {
+		Record &record = _records[(_nextIndex + RECORD_COUNT - 1) % RECORD_COUNT];
+		uint32_t &offset = record.OffsetUs[static_cast<size_t>(phase)];
+		if (offset == NOT_REACHED) {
+			offset = elapsed_us(record.StartCycle);
+		}
+	}
+	trace_exit_critical(state);
+}
+
+void LatencyTrace::EndAttempt() {
+	_isAttemptOpen = false;
+}
+
+LatencyTrace::PhaseSummary LatencyTrace::Summarize(Phase phase) const {
+	std::array<uint32_t, RECORD_COUNT> samples;
+	size_t count = 0;
+	uint64_t sum = 0;
+	for (size_t i = 0; i < _recordCount; i++) {
+		const uint32_t offset = _records[i].OffsetUs[static_cast<size_t>(phase)];
+		if (offset != NOT_REACHED) {
+			samples[count++] = offset;
+			sum += offset;
+		}
+	}
+
+	if (count == 0) {
+		return {};
+	}
+
+	std::sort(samples.begin(), samples.begin() + count);
+	// 最近秩法: 第 ceil(0.99 * n) 个样本
+	const size_t p99Rank = (count * 99 + 99) / 100;
+	return {
+		.Count = static_cast<uint16_t>(count),
+		.MinUs = samples[0],
+		.AvgUs = static_cast<uint32_t>(sum / count),
+		.P99Us = samples[p99Rank - 1]
+	};
+}
+
+size_t LatencyTrace::FormatRecord(size_t index, std::span<char> output) const {
+	const Record &record = _recordAt(index);
+	char *buffer = output.data();
+
+	*buffer++ = '#';
+	buffer += uint16ToString(static_cast<uint16_t>(index), buffer);
+	for (size_t i = 0; i < PHASE_COUNT; i++) {
+		*buffer++ = ' ';
+		buffer = std::copy(PhaseNames[i].begin(), PhaseNames[i].end(), buffer);
+		*buffer++ = '=';
+		if (record.OffsetUs[i] == NOT_REACHED) {
+			*buffer++ = '-';
+		} else {
+			buffer += uint32ToString(record.OffsetUs[i], buffer);
+		}
+	}
+	*buffer++ = '\n';
+	*buffer = '\0';
+	return buffer - output.data();
+}
+
+size_t LatencyTrace::FormatSummary(Phase phase, std::span<char> output) const {
+	const PhaseSummary summary = Summarize(phase);
+	const std::string_view name = PhaseNames[static_cast<size_t>(phase)];
+	char *buffer = std::copy(name.begin(), name.end(), output.data());
+
+	constexpr std::string_view countLabel = " n=";
+	constexpr std::string_view minLabel = " min=";
+	constexpr std::string_view avgLabel = " avg=";
+	constexpr std::string_view p99Label = " p99=";
+	buffer = std::copy(countLabel.begin(), countLabel.end(), buffer);
+	buffer += uint16ToString(summary.Count, buffer);
+	buffer = std::copy(minLabel.begin(), minLabel.end(), buffer);
+	buffer += uint32ToString(summary.MinUs, buffer);
+	buffer = std::copy(avgLabel.begin(), avgLabel.end(), buffer);
+	buffer += uint32ToString(summary.AvgUs, buffer);
+	buffer = std::copy(p99Label.begin(), p99Label.end(), buffer);
+	buffer += uint32ToString(summary.P99Us, buffer);
+	*buffer++ = '\n';
+	*buffer = '\0';
+	return buffer - output.data();
+}
+
+const LatencyTrace::Record &LatencyTrace::_recordAt(size_t index) const {
+	// 记录未写满时最旧的记录位于 0，写满后位于 _nextIndex
+	const size_t oldest = _recordCount < RECORD_COUNT ? 0 : _nextIndex;
+	return _records[(oldest + index) % RECORD_COUNT];
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief 触摸到开门的分阶段延迟记录
+ * @details - 每次尝试 (一次触摸) 占用一条记录，记录保存在固定大小的 RAM 环形缓冲区中，最旧的记录被覆盖
+ *          - 时间戳来自 DWT 周期计数器，精度 1 个 CPU 周期，按微秒保存为相对本次触摸的偏移
+ *          - 尝试由触摸开始 (BeginAttempt)，由舵机动作或放弃 (EndAttempt) 结束，没有进行中的尝试时 Mark 被忽略
+ *          - 所有方法都可在中断和任务中调用
+ */
+class LatencyTrace {
+public:
+	// 一次开门尝试中的各个阶段
+	enum class Phase : uint8_t {
+		Touch,          // 触摸 (EXTI 或任务轮询到触摸引脚上升沿)
+		PressQueryTx,   // 发出查询手指在位请求
+		PressQueryRx,   // 得到查询手指在位响应
+		MatchTx,        // 发出匹配请求
+		MatchRx,        // 得到匹配结果
+		ServoPost,      // 开门/复位消息投递到 ServoQueue
+		ServoSetAngle,  // 舵机任务执行 servo.SetAngle
+		Count
+	};
+
+	static constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::Count);
+	static constexpr size_t RECORD_COUNT = 16;                // 环形缓冲区中的记录数量
+	static constexpr uint32_t NOT_REACHED = UINT32_MAX;       // 阶段未到达
+	static constexpr uint32_t ATTEMPT_TIMEOUT_US = 10000000;  // 超过此时间仍未结束的尝试会被新的触摸取代
+
+	// 阶段名称，用于 UART 输出
+	static constexpr std::array<std::string_view, PHASE_COUNT> PhaseNames = {
+		"touch", "qtx", "qrx", "mtx", "mrx", "post", "servo"
+	};
+
+	// 一次尝试的记录
+	struct Record {
+		uint32_t StartCycle = 0;                                         // 开始时的 DWT 周期计数
+		std::array<uint32_t, PHASE_COUNT> OffsetUs = MakeEmptyOffsets(); // 各阶段相对开始的微秒数
+	};
+
+	// 单个阶段的统计 (微秒，相对触摸)
+	struct PhaseSummary {
+		uint16_t Count = 0;  // 到达该阶段的记录数
+		uint32_t MinUs = 0;
+		uint32_t AvgUs = 0;
+		uint32_t P99Us = 0;  // 最近秩法的 99 百分位数，记录数少于 100 时即最大值
+	};
+
+	/**
+	 * @brief 启用 DWT 周期计数器
+	 */
+	void Init();
+
+	/**
+	 * @brief 开始一次新的尝试并记录 Touch 阶段
+	 * @details 已有进行中且未超时的尝试时忽略 (抖动或 EXTI 与任务轮询重复触发)
+	 */
+	void BeginAttempt();
+
+	/**
+	 * @brief 记录当前尝试到达某个阶段，每个阶段只记录第一次
+	 */
+	void Mark(Phase phase);
+
+	/**
+	 * @brief 结束当前尝试
+	 */
+	void EndAttempt();
+
+	/**
+	 * @brief 获取已保存的记录数量 (最多 RECORD_COUNT)
+	 */
+	size_t GetRecordCount() const { return _recordCount; }
+
+	/**
+	 * @brief 获取某阶段在所有已保存记录中的统计
+	 */
+	PhaseSummary Summarize(Phase phase) const;
+
+	/**
+	 * @brief 将一条记录格式化为一行文本
+	 * @param index 记录序号，0 为最旧
+	 * @param output 输出缓冲区，至少 128 字节
+	 * @return 写入的字符数 (以换行结尾，不含结尾的 '\0')
+	 */
+	size_t FormatRecord(size_t index, std::span<char> output) const;
+
+	/**
+	 * @brief 将某阶段的统计格式化为一行文本
+	 * @param phase 阶段
+	 * @param output 输出缓冲区，至少 64 字节
+	 * @return 写入的字符数 (以换行结尾，不含结尾的 '\0')
+	 */
+	size_t FormatSummary(Phase phase, std::span<char> output) const;
+
+private:
+	static constexpr std::array<uint32_t, PHASE_COUNT> MakeEmptyOffsets() {
+		std::array<uint32_t, PHASE_COUNT> offsets{};
+		offsets.fill(NOT_REACHED);
+		return offsets;
+	}
+
+	// 按时间顺序取记录，0 为最旧
+	const Record &_recordAt(size_t index) const;
+
+	std::array<Record, RECORD_COUNT> _records{};
+	size_t _nextIndex = 0;      // 下一条记录写入的位置
+	size_t _recordCount = 0;    // 已保存的记录数量
+	bool _isAttemptOpen = false;
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "LatencyTrace.h"
+
+// 开门延迟记录全局实例
+inline LatencyTrace latencyTrace;
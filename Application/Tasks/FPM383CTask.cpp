@@ -1,16 +1,789 @@
+#include <algorithm>
+#include <array>
+#include <utility>
+
 #include "cmsis_os.h"
 #include "gpio.h"
 
+#include "Button_Shared.h"
+#include "FingerprintIndex_Shared.h"
+#include "FlashConfig_Shared.h"
 #include "FPM383C_Shared.h"
+#include "FPM383CService_Shared.h"
+#include "LatencyTrace_Shared.h"
 
+#include "Tasks.h"
 #include "UARTMessage.h"
 #include "ServoMessage.h"
 
-// static bool pressedLastState = false;
+static bool pressedLastState = false;
+
+// 触摸快速路径: 触摸按钮按下沿 (EXTI) 直接向本任务投递开门请求发起异步匹配，跳过手指在位查询，
+// 匹配结果在接收回调中直接投递给舵机任务；为 false 时只对门内侧模块使用原来的轮询路径
+static constexpr bool UseTouchFastPath = true;
+
+// 高通行量模式: 手指离开 (触摸引脚下降沿) 即结束本次识别，下一位用户可立即开始匹配，
+// 自学习、关灯和休眠推迟到最后一次手指离开 ThroughputIdleDelayMs 之后；每次识别后上报每分钟尝试次数
+static constexpr bool UseThroughputMode = false;
+
+static constexpr uint32_t StandbyDelayMs = 400;        // 识别后关灯前的延迟
+static constexpr uint32_t SettleDelayMs = 600;         // 关灯后再次接受触摸前的延迟
+static constexpr uint32_t ThroughputIdleDelayMs = 3000; // 高通行量模式下手指离开后判定传感器空闲的时间
+static constexpr uint32_t LiftTimeoutMs = 5000;         // 高通行量模式下等待手指离开的上限 (漏掉下降沿时)
+static constexpr uint32_t ThroughputWindowMs = 60000;   // 每分钟尝试次数的统计窗口
+static constexpr uint32_t RecoveryRetryDelayMs = 5000; // 链路恢复全部失败后再次尝试前的延迟
+static constexpr uint32_t IdentityHintValidMs = 10000; // 身份提示 (密码、卡片或远程请求给出的指纹 ID) 的有效期
+static constexpr uint16_t NoIdentityHint = 0xFFFF;
+static constexpr uint8_t EnrollPresses = 6;           // 注册时需要按压的次数
+
+// 希望与指纹模块协商的波特率 (USART2 位于 36MHz 的 APB1 上，115200 的误差约 0.04%)
+static constexpr uint32_t FingerprintBaudRate = 115200;
+
+// 待机批处理: 关灯 + 进入休眠，由驱动背靠背执行，关灯失败时仍然继续休眠
+static const std::array<FPM383C::BatchCommand, 2> StandbyBatch = {
+	FPM383C::BatchCommand::SetLEDControl(FPM383C::LEDControl::ControlInfo(FPM383C::LEDControl::Mode::Off)),
+	FPM383C::BatchCommand::EnterSleepMode()
+};
+
+// 以上次保存的波特率联络模块并协商更高的波特率，最终波特率有变化时写入 Flash
+static void InitFingerprintLink(FPM383C &driver, uint16_t baudRateKey) {
+	const uint16_t storedBaudRate = flashConfig.GetValue(baudRateKey);
+	const uint32_t knownBaudRate = storedBaudRate == FlashConfig::INVALID_VALUE ? 0 : storedBaudRate * 100u;
+
+	auto [initStatus, initErrorCode] = driver.Init(FingerprintBaudRate, knownBaudRate);
+	if (initStatus == FPM383C::Status::OK && driver.GetBaudRate() != knownBaudRate) {
+		flashConfig.SetValue(baudRateKey, static_cast<uint16_t>(driver.GetBaudRate() / 100));
+	}
+
+	UARTMessage initMsg{
+		.type = UARTMessageType::FingerprintInit,
+		.data1 = static_cast<uint8_t>(initStatus),
+		.data2 = static_cast<uint16_t>(driver.GetBaudRate() / 100)
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&initMsg), 0, 50);
+}
+
+// 上报关灯休眠的结果
+static void ReportStandby(FPM383C::CommandResult result) {
+	auto [standbyStatus, standbyErrorCode] = result;
+	UARTMessage standbyMsg{
+		.type = UARTMessageType::FingerprintStandby,
+		.data1 = static_cast<uint8_t>(standbyStatus),
+		.data2 = static_cast<uint16_t>(standbyErrorCode)
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&standbyMsg), 0, 50);
+}
+
+static void EnterStandby(FPM383C &driver) {
+	ReportStandby(driver.RunBatch(StandbyBatch, false).Result);
+}
+
+// 模块给出了确定的匹配结果 (而不是超时、通信或传感器错误)
+static bool IsDefinitiveMatchResult(const FPM383C::MatchResult &result) {
+	if (result.OperationStatus != FPM383C::Status::OK) {
+		return false;
+	}
+	return result.ErrorCode == FPM383C::ModuleErrorCode::None
+		|| result.ErrorCode == FPM383C::ModuleErrorCode::MatchFailedLibEmpty;
+}
+
+// 将匹配结果投递给舵机任务
+static void PostMatchToServo(const FPM383C::MatchResult &result, uint32_t timeout) {
+	ServoMessage openDoorMsg{
+		.type = result.IsSuccess ? ServoMessageType::MoveToUnlockPosition : ServoMessageType::MoveToResetPosition
+	};
+	osMessageQueuePut(ServoQueueHandle, reinterpret_cast<uint32_t *>(&openDoorMsg), 0, timeout);
+	latencyTrace.Mark(LatencyTrace::Phase::ServoPost); // 尝试由舵机任务执行 SetAngle 后结束
+}
+
+static void SendMatchStartMessage(uint16_t hintedId = NoIdentityHint) {
+	UARTMessage startMsg{
+		.type = hintedId == NoIdentityHint ? UARTMessageType::FingerprintMatchStart : UARTMessageType::FingerprintVerifyStart,
+		.data2 = hintedId == NoIdentityHint ? uint16_t{ 0 } : hintedId
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&startMsg), 0, 50);
+}
+
+// 匹配、注册或删除过程中出现错误，发送错误消息
+static void ReportError(FPM383C::Status status, FPM383C::ModuleErrorCode errCode) {
+	UARTMessage msg{
+		.type = UARTMessageType::FingerprintError,
+		.errorCode = static_cast<uint8_t>(status),
+		.moduleErrorCode = static_cast<uint16_t>(errCode)
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&msg), 0, 50);
+}
+
+// 同步匹配并将结果投递给舵机任务，给出已知身份时以 1:1 比对代替 1:N 匹配，失败时发送错误消息并返回 false
+static bool MatchAndPostToServo(FPM383C &driver, FPM383C::MatchResult &matchResult, uint16_t hintedId = NoIdentityHint) {
+	latencyTrace.Mark(LatencyTrace::Phase::MatchTx);
+	auto [matchStatus, matchErrCode] = hintedId == NoIdentityHint ? driver.Match(matchResult) : driver.Verify(hintedId, matchResult);
+	latencyTrace.Mark(LatencyTrace::Phase::MatchRx);
+	if (matchStatus != FPM383C::Status::OK) {
+		latencyTrace.EndAttempt();
+		ReportError(matchStatus, matchErrCode);
+		return false;
+	}
+
+	PostMatchToServo(matchResult, 100); // Servo 队列多等待一些时间
+	return true;
+}
+
+// 加载本地 ID 索引并与模块核对
+static void ReconcileIndex(FPM383C &driver, FingerprintIndex &index) {
+	index.Load();
+	const FingerprintIndex::Status status = index.Reconcile(driver);
+	UARTMessage reconcileMsg{
+		.type = UARTMessageType::FingerprintIndexReconcile,
+		.data1 = static_cast<uint8_t>(status),
+		.data2 = index.GetCount()
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&reconcileMsg), 0, 50);
+}
+
+// 上报已交给舵机任务的匹配结果，匹配成功时查找所属用户并推迟自学习到模块空闲时
+static void ReportMatch(FPM383C &driver, const FPM383C::MatchResult &matchResult, const FingerprintIndex *index) {
+	UARTMessage msg{
+		.type = UARTMessageType::FingerprintMatchComplete,
+		.fingerprintMatchResult = matchResult.IsSuccess,
+		.fingerprintId = matchResult.FingerId
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&msg), 0, 50);
+
+	const FingerprintIndex::Metadata *metadata = index != nullptr ? index->Find(matchResult.FingerId) : nullptr;
+	if (matchResult.IsSuccess && metadata != nullptr) {
+		// 本地查表得到用户，无需与模块往返
+		UARTMessage userMsg{
+			.type = UARTMessageType::FingerprintMatchUser,
+			.data1 = metadata->Flags,
+			.data2 = metadata->UserId
+		};
+		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&userMsg), 0, 50);
+	}
+
+	if (matchResult.IsSuccess) {
+		// 匹配成功，自学习 (模块写 Flash) 不占用开门路径
+		driver.DeferFeatureUpdate(matchResult.FingerId);
+	}
+}
+
+// 上报注册开始，fingerId 为本地索引分配的 ID (0xFFFF 表示由模块分配)
+static void ReportEnrollStart(uint16_t fingerId) {
+	UARTMessage startMsg{
+		.type = UARTMessageType::FingerprintEnrollStart,
+		.fingerprintId = fingerId
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&startMsg), 0, 50);
+}
+
+// 上报注册进度
+static void ReportEnrollStep(const FPM383C::EnrollStatus &status) {
+	UARTMessage stepMsg{
+		.type = UARTMessageType::FingerprintEnrollStep,
+		.fingerprintEnrollStep = status.Step,
+		.data2 = status.Progress
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&stepMsg), 0, 50);
+}
+
+// 注册结束: 成功时在本地索引中记录所属用户并上报最终 ID (附带写入索引的状态)，失败时发送错误消息
+static void FinishEnroll(FPM383C::CommandResult result, uint16_t fingerId, FingerprintIndex *index, uint16_t userId) {
+	auto [enrollStatus, enrollErrCode] = result;
+	if (enrollStatus != FPM383C::Status::OK) {
+		ReportError(enrollStatus, enrollErrCode);
+		return;
+	}
+
+	const FingerprintIndex::Status recordStatus = index != nullptr
+		? index->Record(fingerId, { .UserId = userId })
+		: FingerprintIndex::Status::Ok;
+	UARTMessage completeMsg{
+		.type = UARTMessageType::FingerprintEnrollComplete,
+		.data1 = static_cast<uint8_t>(recordStatus),
+		.fingerprintId = fingerId
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&completeMsg), 0, 50);
+}
+
+// 删除结束: 成功时从本地索引中移除并上报 (附带写入索引的状态)，失败时发送错误消息
+static void FinishDelete(FPM383C::CommandResult result, uint16_t fingerId, FingerprintIndex *index) {
+	auto [deleteStatus, deleteErrCode] = result;
+	if (deleteStatus != FPM383C::Status::OK) {
+		ReportError(deleteStatus, deleteErrCode);
+		return;
+	}
+
+	const FingerprintIndex::Status removeStatus = index != nullptr ? index->Remove(fingerId) : FingerprintIndex::Status::Ok;
+	UARTMessage deleteMsg{
+		.type = UARTMessageType::FingerprintDelete,
+		.data1 = static_cast<uint8_t>(removeStatus),
+		.fingerprintId = fingerId
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&deleteMsg), 0, 50);
+}
+
+// 注册指纹并记录所属用户 (阻塞，轮询路径使用)
+static FPM383C::CommandResult EnrollFingerprint(FPM383C &driver, FingerprintIndex &index, uint16_t userId) {
+	const uint16_t fingerId = index.AllocateId();
+	ReportEnrollStart(fingerId);
+	FPM383C::EnrollStatus finalStatus;
+	const FPM383C::CommandResult result = driver.AutoEnroll(finalStatus, fingerId, EnrollPresses,
+		[](const FPM383C::EnrollStatus &status) { ReportEnrollStep(status); });
+	FinishEnroll(result, finalStatus.FingerId, &index, userId);
+	return result;
+}
+
+// 删除指纹并更新本地索引 (阻塞，轮询路径使用)
+static FPM383C::CommandResult DeleteFingerprint(FPM383C &driver, FingerprintIndex &index, uint16_t fingerId) {
+	const FPM383C::CommandResult result = driver.DeleteFingerprint(fingerId);
+	FinishDelete(result, fingerId, &index);
+	return result;
+}
+
+// 上报自学习的结果
+static void ReportFeatureUpdate(FPM383C::CommandResult result) {
+	auto [updateStatus, updateErrCode] = result;
+	if (updateStatus == FPM383C::Status::OK || updateErrCode == FPM383C::ModuleErrorCode::FeatureNotNeedUpdate) {
+		// 自学习成功，发送成功消息
+		UARTMessage updateSuccessMsg{
+			.type = UARTMessageType::FingerprintUpdateFeatureAfterMatch,
+			.data1 = static_cast<uint8_t>(updateStatus),
+			.data2 = static_cast<uint16_t>(updateErrCode)
+		};
+		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&updateSuccessMsg), 0, 50);
+	} else {
+		// 自学习过程中出现错误，发送错误消息
+		UARTMessage updateMsg{
+			.type = UARTMessageType::FingerprintError,
+			.errorCode = static_cast<uint8_t>(updateStatus),
+			.moduleErrorCode = static_cast<uint16_t>(updateErrCode)
+		};
+		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&updateMsg), 0, 50);
+	}
+}
+
+// 执行推迟的自学习并上报结果
+static void RunDeferredFeatureUpdate(FPM383C &driver) {
+	uint16_t fingerId;
+	const FPM383C::CommandResult result = driver.RunDeferredFeatureUpdate(fingerId);
+	if (fingerId != 0xFFFF) {
+		ReportFeatureUpdate(result);
+	}
+}
+
+// 上报恢复级别和中断时长 (毫秒，失败时为 0xFFFF)
+static void ReportRecovery(FPM383C &driver, FPM383C::RecoveryLevel level) {
+	const uint32_t outageMs = level == FPM383C::RecoveryLevel::Failed ? UINT16_MAX : driver.GetRecoveryStats().LastOutageMs;
+	UARTMessage recoveryMsg{
+		.type = UARTMessageType::FingerprintRecovery,
+		.data1 = static_cast<uint8_t>(level),
+		.data2 = static_cast<uint16_t>(std::min<uint32_t>(outageMs, UINT16_MAX))
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&recoveryMsg), 0, 50);
+}
+
+// 链路中断时逐级恢复并上报 (阻塞，轮询路径使用)
+static FPM383C::RecoveryLevel RecoverLink(FPM383C &driver) {
+	if (!driver.IsLinkDown()) {
+		return FPM383C::RecoveryLevel::None;
+	}
+
+	const FPM383C::RecoveryLevel level = driver.Recover();
+	ReportRecovery(driver, level);
+	return level;
+}
+
+// 截止时间是否已到 (滴答计数回绕安全)
+static bool IsDeadlineReached(uint32_t now, uint32_t deadline) {
+	return static_cast<int32_t>(now - deadline) >= 0;
+}
+
+/**
+ * @brief 每分钟识别尝试次数 (滑动窗口近似)
+ * @details 只保存当前和上一个 60 秒窗口的计数，上一个窗口按尚未滑出的比例计入，不需要保存每次尝试的时刻
+ */
+class AttemptRateMeter {
+public:
+	void Record(uint32_t now) {
+		_roll(now);
+		_currentCount++;
+	}
+
+	uint16_t GetAttemptsPerMinute(uint32_t now) {
+		_roll(now);
+		const uint32_t elapsed = now - _windowStartTick;
+		const uint32_t previousShare = _previousCount * (ThroughputWindowMs - elapsed) / ThroughputWindowMs;
+		return static_cast<uint16_t>(std::min<uint32_t>(_currentCount + previousShare, UINT16_MAX));
+	}
+
+private:
+	// 进入新的窗口时把当前计数移入上一个窗口，空闲超过两个窗口时两者都清零
+	void _roll(uint32_t now) {
+		const uint32_t elapsed = now - _windowStartTick;
+		if (elapsed < ThroughputWindowMs) {
+			return;
+		}
+		_previousCount = elapsed < 2 * ThroughputWindowMs ? _currentCount : 0;
+		_currentCount = 0;
+		_windowStartTick = now - elapsed % ThroughputWindowMs;
+	}
+
+	uint32_t _windowStartTick = 0;
+	uint32_t _currentCount = 0;
+	uint32_t _previousCount = 0;
+};
+
+// 上报每分钟尝试次数
+static void ReportThroughput(AttemptRateMeter &meter) {
+	UARTMessage throughputMsg{
+		.type = UARTMessageType::FingerprintThroughput,
+		.data2 = meter.GetAttemptsPerMinute(osKernelGetTickCount())
+	};
+	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&throughputMsg), 0, 50);
+}
+
+/**
+ * @brief 一个指纹传感器 (模块 + 触摸按钮) 的触摸快速路径
+ * @details - 每次识别、注册、删除和链路恢复都是一个协程 (会话)，在模块上异步进行的步骤以 co_await 驱动的可等待操作表示，
+ *            协程都在本任务中由 fpm383cService 的执行器恢复，因此一个任务 (一份栈) 可以同时服务多个传感器，
+ *            一个传感器的慢操作不会阻塞其他传感器
+ *          - 触摸由中断投递为 fpm383cService 的开门路径请求，匹配结果由驱动的完成队列在本任务中交给等待的协程，接收中断不执行应用代码
+ *          - 识别后的延迟是可被新的触摸提前唤醒的协程等待，代替 osDelay，期间其他传感器不受影响
+ *          - 高通行量模式下手指离开即回到可识别状态，待机推迟到传感器空闲之后
+ */
+class FingerprintSensor {
+public:
+	FingerprintSensor(FPM383C &driver, Button &touchButton, uint16_t baudRateKey, FingerprintIndex *index = nullptr)
+		: _driver(driver), _touchButton(touchButton), _baudRateKey(baudRateKey), _index(index),
+		_wakeup(fpm383cService.GetExecutor()),
+		_touchRequest{ .Op = [this](FPM383C &) { return _onTouch(); }, .Driver = &driver } { }
+
+	FingerprintSensor(const FingerprintSensor &) = delete;
+	FingerprintSensor &operator=(const FingerprintSensor &) = delete;
+
+	FPM383C &GetDriver() { return _driver; }
+
+	/**
+	 * @brief 注册 UART 分发，联络模块并协商波特率，核对本地 ID 索引
+	 */
+	void Init() {
+		fpm383cRegistry.Register(_driver);
+		InitFingerprintLink(_driver, _baudRateKey);
+		if (_index != nullptr) {
+			ReconcileIndex(_driver, *_index);
+		}
+	}
+
+	/**
+	 * @brief 让驱动的可等待操作在执行器上恢复，注册触摸回调，开始响应触摸
+	 */
+	void EnableFastPath() {
+		_driver.SetResumeScheduler(ScheduleOnCoExecutor);
+		_driver.RegisterEnrollProgressCallback([this](const FPM383C::EnrollStatus &status) { _onEnrollProgress(status); });
+		_driver.SetCompletionNotifier([] { fpm383cService.Wake(); });
+		_touchButton.RegisterPressCallback([this] { _onTouchPressed(); });
+		_touchButton.RegisterReleaseCallback([this] { _onTouchReleased(); });
+	}
+
+	/**
+	 * @brief 给出下一次触摸的已知身份，有效期内的触摸以 1:1 比对代替 1:N 匹配
+	 * @details 可在任意任务或 ISR 中调用，之后的提示覆盖之前的提示；ID 与有效期在临界区中成对写入
+	 * @param fingerId 密码、卡片或远程请求对应的指纹 ID
+	 */
+	void HintIdentity(uint16_t fingerId) {
+		const uint32_t expiryTick = osKernelGetTickCount() + IdentityHintValidMs;
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		_hintedFingerId = fingerId;
+		_hintExpiryTick = expiryTick;
+		__set_PRIMASK(primask);
+	}
+
+	/**
+	 * @brief 取出仍有效的身份提示，每个提示只用于一次触摸
+	 * @return 指纹 ID，没有有效提示时为 NoIdentityHint
+	 */
+	uint16_t TakeIdentityHint(uint32_t now) {
+		// 取出与清除在临界区中完成，同时给出的新提示不会被一并清除，也不会与旧提示的有效期混用
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		const uint16_t fingerId = std::exchange(_hintedFingerId, NoIdentityHint);
+		const uint32_t expiryTick = _hintExpiryTick;
+		__set_PRIMASK(primask);
+		return fingerId != NoIdentityHint && !IsDeadlineReached(now, expiryTick) ? fingerId : NoIdentityHint;
+	}
+
+	/**
+	 * @brief 开始注册会话，ID 由本地索引分配 (索引不可信时由模块分配)，成功后在索引中记录所属用户
+	 * @details 必须在所有者任务中调用；注册期间的触摸取消注册并开始识别
+	 * @param userId 所属用户
+	 * @return AsyncInProgress 表示已开始，Busy 表示正在识别、执行其他操作或链路中断
+	 */
+	FPM383C::CommandResult StartEnroll(uint16_t userId) {
+		if (!_canStartMaintenance()) {
+			return { FPM383C::Status::Busy, FPM383C::ModuleErrorCode::None };
+		}
+		const uint16_t fingerId = _index != nullptr ? _index->AllocateId() : FingerprintIndex::INVALID_ID;
+		return { _startMaintenance(State::Enrolling, _enrollSession(fingerId, userId)), FPM383C::ModuleErrorCode::None };
+	}
+
+	/**
+	 * @brief 开始删除会话，成功后从本地索引中移除
+	 * @details 必须在所有者任务中调用；删除期间的触摸在删除完成后开始匹配
+	 * @param fingerId 要删除的指纹 ID
+	 * @return AsyncInProgress 表示已开始，Busy 表示正在识别、执行其他操作或链路中断
+	 */
+	FPM383C::CommandResult StartDelete(uint16_t fingerId) {
+		if (!_canStartMaintenance()) {
+			return { FPM383C::Status::Busy, FPM383C::ModuleErrorCode::None };
+		}
+		return { _startMaintenance(State::Deleting, _deleteSession(fingerId)), FPM383C::ModuleErrorCode::None };
+	}
+
+	/**
+	 * @brief 分发驱动完成队列中的异步结果 (等待中的协程交给执行器，注册进度回调在此执行)
+	 */
+	void DispatchCompletions() {
+		_driver.DispatchCompletions();
+	}
+
+	/**
+	 * @brief 高通行量模式下手指离开时唤醒等待的识别会话
+	 */
+	void Poll() {
+		if (_state == State::AwaitingLift && !_isFingerDown) {
+			_wakeup.Notify();
+		}
+	}
+
+	/**
+	 * @brief 空闲且链路中断时开始链路恢复会话 (会话进行中时由其异步操作的截止时间先结束)
+	 * @param now 当前滴答
+	 */
+	void RecoverIfLinkDown(uint32_t now) {
+		if (_state != State::Idle || !_driver.IsLinkDown() || !IsDeadlineReached(now, _recoveryRetryTick)) {
+			return;
+		}
+		_state = State::Recovering;
+		if (!fpm383cService.Spawn(_recoverySession())) {
+			_state = State::Idle;
+			_recoveryRetryTick = now + RecoveryRetryDelayMs;
+		}
+	}
+
+	/**
+	 * @brief 距离下一次链路恢复尝试的滴答数 (会话中的延迟由执行器计时)
+	 * @return 链路正常或有会话进行中时为 osWaitForever
+	 */
+	uint32_t GetTimeUntilRecovery(uint32_t now) const {
+		if (_state != State::Idle || !_driver.IsLinkDown()) {
+			return osWaitForever;
+		}
+		return IsDeadlineReached(now, _recoveryRetryTick) ? 0 : _recoveryRetryTick - now;
+	}
+
+private:
+	enum class State : uint8_t {
+		Idle,         // 等待触摸
+		Matching,     // 异步匹配进行中
+		AwaitingLift, // 高通行量模式: 已识别，等待手指离开，可接受新的触摸
+		Cooldown,     // 已识别，等待自学习和关灯，可接受新的触摸
+		Enrolling,    // 异步注册进行中，期间的触摸取消注册并开始识别
+		Deleting,     // 异步删除进行中，期间的触摸在完成后开始匹配
+		Learning,     // 异步自学习进行中，期间的触摸在完成后开始匹配
+		Standby,      // 异步关灯休眠进行中
+		Settling,     // 已关灯，等待再次接受触摸
+		Recovering    // 异步链路恢复进行中，期间的触摸在恢复后开始匹配
+	};
+
+	// 是否可以开始注册或删除 (识别后的等待会被提前结束)
+	bool _canStartMaintenance() const {
+		return (_state == State::Idle || _state == State::Cooldown || _state == State::AwaitingLift) && !_driver.IsLinkDown();
+	}
+
+	// 识别会话是否仍在识别后的等待中 (等待期间开始了注册或删除时由其负责关灯休眠)
+	bool _isAfterMatch() const {
+		return _state == State::Cooldown || _state == State::AwaitingLift;
+	}
+
+	// 触摸按钮按下回调 (EXTI 中断中调用)
+	void _onTouchPressed() {
+		_isFingerDown = true;
+		_isTouchPending = fpm383cService.Post(_touchRequest, FPM383CService::Priority::Unlock);
+	}
+
+	// 触摸按钮释放回调 (EXTI 中断中调用)，高通行量模式下由本任务唤醒等待手指离开的会话
+	void _onTouchReleased() {
+		_isFingerDown = false;
+		if (UseThroughputMode) {
+			fpm383cService.Wake();
+		}
+	}
+
+	// 模块被触摸唤醒 (本任务): 空闲或注册中时开始识别会话，识别后的等待中提前开始下一次识别，
+	// 删除、自学习或链路恢复期间记下触摸，完成后再开始匹配
+	FPM383C::CommandResult _onTouch() {
+		_isTouchPending = false;
+		switch (_state) {
+		case State::Idle:
+		case State::Enrolling:
+			return { _spawnMatch(), FPM383C::ModuleErrorCode::None };
+		case State::AwaitingLift:
+		case State::Cooldown:
+		case State::Deleting:
+		case State::Learning:
+		case State::Recovering:
+			_isMatchRequested = true;
+			_wakeup.Notify();
+			return { FPM383C::Status::OK, FPM383C::ModuleErrorCode::None };
+		default:
+			// 匹配期间或刚休眠时的重复触摸
+			return { FPM383C::Status::Busy, FPM383C::ModuleErrorCode::None };
+		}
+	}
+
+	// 开始识别会话，协程帧分配失败时放弃本次触摸
+	FPM383C::Status _spawnMatch() {
+		const State previous = _state;
+		_state = State::Matching;
+		_isMatchRequested = true;
+		if (!fpm383cService.Spawn(_matchSession())) {
+			_state = previous;
+			_isMatchRequested = false;
+			return FPM383C::Status::Busy;
+		}
+		return FPM383C::Status::AsyncInProgress;
+	}
+
+	// 开始注册或删除会话，结束识别后的等待 (识别会话醒来后发现状态已改变即退出)
+	FPM383C::Status _startMaintenance(State state, CoTask<void> &&session) {
+		const State previous = _state;
+		_state = state;
+		if (!fpm383cService.Spawn(std::move(session))) {
+			_state = previous;
+			return FPM383C::Status::Busy;
+		}
+		_wakeup.Notify();
+		return FPM383C::Status::AsyncInProgress;
+	}
+
+	// 发出本次识别的匹配命令: 给出已知身份时以 1:1 比对代替 1:N 匹配，耗时与指纹库大小无关；
+	// 门口的用户优先: 进行中的异步注册被取消 (不等待取消应答)
+	FPM383C::MatchAwaiter _matchAsync(uint16_t hintedId) {
+		return hintedId == NoIdentityHint ? _driver.MatchAsync(true) : _driver.VerifyAsync(hintedId, true);
+	}
+
+	// 识别会话: 匹配后先交给舵机任务，识别后的等待中有新的触摸时继续下一次识别，
+	// 传感器空闲后执行推迟的自学习，最后关灯休眠
+	CoTask<void> _matchSession() {
+		while (std::exchange(_isMatchRequested, false)) {
+			_state = State::Matching;
+			const uint32_t now = osKernelGetTickCount();
+			_attemptRate.Record(now);
+			const uint16_t hintedId = TakeIdentityHint(now);
+			SendMatchStartMessage(hintedId);
+
+			FPM383C::MatchResult result;
+			for (bool hasRetried = false; ; hasRetried = true) {
+				latencyTrace.Mark(LatencyTrace::Phase::MatchTx);
+				result = (co_await _matchAsync(hintedId)).second;
+				latencyTrace.Mark(LatencyTrace::Phase::MatchRx);
+				// 模块可能尚未从休眠中就绪，重试一次；超时已使链路中断，交给链路恢复
+				if (hasRetried || IsDefinitiveMatchResult(result) || _driver.IsLinkDown()) {
+					break;
+				}
+			}
+
+			if (!IsDefinitiveMatchResult(result)) {
+				latencyTrace.EndAttempt();
+				ReportError(result.OperationStatus == FPM383C::Status::OK ? FPM383C::Status::ModuleError : result.OperationStatus,
+					result.ErrorCode);
+				if (_isEnrollActive) {
+					// 未能取消注册，注册结束后由注册会话关灯休眠
+					_state = State::Enrolling;
+					co_return;
+				}
+				break;
+			}
+
+			PostMatchToServo(result, 100);
+			ReportMatch(_driver, result, _index);
+			if constexpr (UseThroughputMode) {
+				ReportThroughput(_attemptRate);
+				_state = State::AwaitingLift;
+				if (_isFingerDown) {
+					// 漏掉下降沿时按超时处理
+					co_await _wakeup.Wait(LiftTimeoutMs);
+				}
+				if (_isAfterMatch() && !_isMatchRequested) {
+					// 手指已离开，本次识别结束；空闲计时从此刻开始
+					_state = State::Cooldown;
+					co_await _wakeup.Wait(ThroughputIdleDelayMs);
+				}
+			} else {
+				_state = State::Cooldown;
+				co_await _wakeup.Wait(StandbyDelayMs);
+			}
+			if (!_isAfterMatch()) {
+				co_return;
+			}
+			if (_isMatchRequested) {
+				continue;
+			}
+
+			// 模块空闲: 执行推迟的自学习后关灯休眠；自学习期间的触摸在完成后开始匹配 (不再关灯)
+			_state = State::Learning;
+			const auto [fingerId, updateResult] = co_await _driver.DeferredFeatureUpdateAsync();
+			if (fingerId != 0xFFFF) {
+				ReportFeatureUpdate(updateResult);
+			}
+		}
+		co_await _standby();
+	}
+
+	// 期间有新的触摸时开始识别 (不再关灯)，否则关灯休眠，完成后等待 SettleDelayMs 再接受触摸；
+	// 链路中断时关灯必然超时，直接等待恢复
+	CoTask<void> _standby() {
+		if (std::exchange(_isMatchRequested, false) && _spawnMatch() == FPM383C::Status::AsyncInProgress) {
+			co_return;
+		}
+		if (!_driver.IsLinkDown()) {
+			_state = State::Standby;
+			ReportStandby((co_await _driver.BatchAsync(StandbyBatch, false)).Result);
+		}
+		_state = State::Settling;
+		co_await fpm383cService.GetExecutor().Delay(SettleDelayMs);
+		_state = State::Idle;
+	}
+
+	// 注册会话: 进度由进度回调上报，被识别取消时同样上报结果，此时由识别会话关灯休眠
+	CoTask<void> _enrollSession(uint16_t fingerId, uint16_t userId) {
+		ReportEnrollStart(fingerId);
+		_isEnrollActive = true;
+		const auto [status, finalStatus] = co_await _driver.AutoEnrollAsync(fingerId, EnrollPresses);
+		_isEnrollActive = false;
+		FinishEnroll({ status, finalStatus.ErrorCode }, finalStatus.FingerId, _index, userId);
+		if (_state == State::Enrolling) {
+			co_await _standby();
+		}
+	}
+
+	// 注册进度回调 (由 DispatchCompletions() 在本任务中调用)，出错时只由注册会话上报
+	void _onEnrollProgress(const FPM383C::EnrollStatus &status) {
+		if (_isEnrollActive && status.ErrorCode == FPM383C::ModuleErrorCode::None) {
+			ReportEnrollStep(status);
+		}
+	}
+
+	// 删除会话: 删除后更新本地索引，期间有触摸时开始识别，否则关灯休眠
+	CoTask<void> _deleteSession(uint16_t fingerId) {
+		const FPM383C::BatchResult result = co_await _driver.CommandAsync(FPM383C::BatchCommand::DeleteFingerprint(fingerId));
+		FinishDelete(result.Result, fingerId, _index);
+		co_await _standby();
+	}
+
+	// 链路恢复会话: 全部失败时 RecoveryRetryDelayMs 后再试，恢复期间有触摸时开始识别
+	CoTask<void> _recoverySession() {
+		const auto [status, level] = co_await _driver.RecoverAsync();
+		if (status == FPM383C::Status::AsyncInProgress) {
+			ReportRecovery(_driver, level);
+		}
+		if (level == FPM383C::RecoveryLevel::Failed || (status != FPM383C::Status::OK && status != FPM383C::Status::AsyncInProgress)) {
+			_recoveryRetryTick = osKernelGetTickCount() + RecoveryRetryDelayMs;
+		}
+
+		_state = State::Idle;
+		if (std::exchange(_isMatchRequested, false)) {
+			_spawnMatch();
+		}
+	}
+
+	FPM383C &_driver;
+	Button &_touchButton;
+	uint16_t _baudRateKey;              // 保存协商波特率的 Flash 配置键
+	FingerprintIndex *_index;           // 本地 ID 索引，可为空
+
+	State _state = State::Idle;
+	uint32_t _recoveryRetryTick = 0;    // 链路恢复失败后下一次尝试的滴答
+	volatile bool _isTouchPending = false; // 触摸请求已投递尚未执行
+	volatile bool _isFingerDown = false;   // 触摸按钮处于按下状态 (由 EXTI 回调维护)
+	bool _isMatchRequested = false;        // 有待开始的识别 (识别后的等待、删除、自学习或链路恢复期间的触摸)
+	bool _isEnrollActive = false;          // 注册会话正在等待注册结束 (被识别取消时状态已不是 Enrolling)
+	AttemptRateMeter _attemptRate;         // 每分钟尝试次数
+	uint16_t _hintedFingerId = NoIdentityHint; // 身份提示给出的指纹 ID (只在临界区中访问)
+	uint32_t _hintExpiryTick = 0;              // 身份提示失效的滴答 (只在临界区中访问)
+
+	CoSignal _wakeup;                           // 唤醒识别后等待中的会话 (新的触摸、手指离开或开始注册、删除)
+	FPM383CService::Request _touchRequest;      // 触摸开门请求，由 EXTI 中断投递
+};
+
+// 门内侧传感器
+static FingerprintSensor insideSensor(fpm383c, fingerprintTouchButton, FlashConfigKey::FingerprintBaudRate, &fingerprintIndex);
+
+// 由本任务服务的所有传感器，双面门在此追加室外传感器
+static const std::array<FingerprintSensor *, 1> sensors = { &insideSensor };
+
+void HintFingerprintIdentity(uint16_t fingerId) {
+	insideSensor.HintIdentity(fingerId);
+}
+
+bool RequestFingerprintEnroll(uint16_t userId) {
+	const FPM383C::Status status = fpm383cService.Call(insideSensor.GetDriver(), [userId](FPM383C &driver) {
+		if constexpr (UseTouchFastPath) {
+			return insideSensor.StartEnroll(userId);
+		} else {
+			return EnrollFingerprint(driver, fingerprintIndex, userId);
+		}
+	}).first;
+	return status == FPM383C::Status::OK || status == FPM383C::Status::AsyncInProgress;
+}
+
+bool RequestFingerprintDelete(uint16_t fingerId) {
+	const FPM383C::Status status = fpm383cService.Call(insideSensor.GetDriver(), [fingerId](FPM383C &driver) {
+		if constexpr (UseTouchFastPath) {
+			return insideSensor.StartDelete(fingerId);
+		} else {
+			return DeleteFingerprint(driver, fingerprintIndex, fingerId);
+		}
+	}).first;
+	return status == FPM383C::Status::OK || status == FPM383C::Status::AsyncInProgress;
+}
+
+// 触摸快速路径主循环: 触摸和其他任务的请求经由服务邮箱执行，会话协程由服务的执行器恢复，异步结果由驱动的完成队列分发
+[[noreturn]] static void RunTouchFastPath() {
+	for (FingerprintSensor *sensor : sensors) {
+		sensor->EnableFastPath();
+	}
+
+	while (true) {
+		// 等待请求，最多等到最近的链路恢复重试 (协程的延迟由执行器计时)
+		uint32_t now = osKernelGetTickCount();
+		uint32_t timeout = osWaitForever;
+		for (const FingerprintSensor *sensor : sensors) {
+			timeout = std::min(timeout, sensor->GetTimeUntilRecovery(now));
+		}
+
+		fpm383cService.WaitAndProcess(timeout);
+
+		now = osKernelGetTickCount();
+		for (FingerprintSensor *sensor : sensors) {
+			sensor->DispatchCompletions();
+			sensor->Poll();
+			sensor->RecoverIfLinkDown(now);
+		}
+	}
+}
 
 void FPM383CTask() {
+	// 本任务是驱动的唯一所有者，其他任务通过 fpm383cService 访问模块
+	fpm383cService.Init();
+
 	osDelay(300);
 
+	for (FingerprintSensor *sensor : sensors) {
+		sensor->Init();
+	}
+
 	// 为什么死都没法关灯啊
 
 	// bool isPressed = false;
@@ -28,13 +801,15 @@ void FPM383CTask() {
 
 	osDelay(100);
 
-	auto [enterSleepModeStatus, enterSleepModeErrorCode] = fpm383c.EnterSleepMode();
-	UARTMessage sleepMsg{
-		.type = UARTMessageType::FingerprintEnterSleepMode,
-		.data1 = static_cast<uint8_t>(enterSleepModeStatus),
-		.data2 = static_cast<uint16_t>(enterSleepModeErrorCode)
-	};
-	osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&sleepMsg), 0, 50);
+	for (FingerprintSensor *sensor : sensors) {
+		auto [enterSleepModeStatus, enterSleepModeErrorCode] = sensor->GetDriver().EnterSleepMode();
+		UARTMessage sleepMsg{
+			.type = UARTMessageType::FingerprintEnterSleepMode,
+			.data1 = static_cast<uint8_t>(enterSleepModeStatus),
+			.data2 = static_cast<uint16_t>(enterSleepModeErrorCode)
+		};
+		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&sleepMsg), 0, 50);
+	}
 
 	// fpm383c.SetLEDControl(FPM383C::LEDControl::ControlInfo(
 	// 	FPM383C::LEDControl::Mode::Off
@@ -42,17 +817,57 @@ void FPM383CTask() {
 
 	osDelay(100);
 
+	if constexpr (UseTouchFastPath) {
+		RunTouchFastPath();
+	}
+
+	// 高通行量模式的轮询路径状态
+	AttemptRateMeter attemptRate;
+	bool isAwaitingLift = false;    // 已识别，等待手指离开
+	bool isStandbyPending = false;  // 已识别，等待传感器空闲后关灯休眠
+	uint32_t throughputDeadline = 0;
+
 	while (true) {
 		if (HAL_GPIO_ReadPin(FingerprintModuleTouchSensor_GPIO_Port, FingerprintModuleTouchSensor_Pin) == GPIO_PIN_RESET) {
-			// pressedLastState = false;
-			osDelay(50);
+			pressedLastState = false;
+			const uint32_t now = osKernelGetTickCount();
+			if (isAwaitingLift) {
+				// 手指已离开，本次识别结束；空闲计时从此刻开始
+				isAwaitingLift = false;
+				isStandbyPending = true;
+				throughputDeadline = now + ThroughputIdleDelayMs;
+			} else if (isStandbyPending && IsDeadlineReached(now, throughputDeadline)) {
+				isStandbyPending = false;
+				RunDeferredFeatureUpdate(fpm383c);
+				EnterStandby(fpm383c);
+			}
+			fpm383cService.WaitAndProcess(isStandbyPending ? 10 : 50); // 等待触摸期间处理其他任务的请求
 			continue;
 		}
 
-		// pressedLastState = true;
+		if (isAwaitingLift) {
+			if (!IsDeadlineReached(osKernelGetTickCount(), throughputDeadline)) {
+				fpm383cService.WaitAndProcess(10);
+				continue;
+			}
+			// 等待超时 (手指一直未离开)，按新的一次触摸处理
+			isAwaitingLift = false;
+		}
+		isStandbyPending = false;
+
+		if (!pressedLastState) {
+			// 轮询到触摸上升沿 (EXTI 已记录时忽略)
+			latencyTrace.BeginAttempt();
+		}
+		pressedLastState = true;
+
 		bool isPressed = false;
+		latencyTrace.Mark(LatencyTrace::Phase::PressQueryTx);
 		auto [status, ModuleErrorCode] = fpm383c.IsFingerPressed(isPressed);
+		latencyTrace.Mark(LatencyTrace::Phase::PressQueryRx);
 		if (status != FPM383C::Status::OK) {
+			latencyTrace.EndAttempt();
+
 			// 通信存在问题，发送错误消息
 			UARTMessage msg{
 				.type = UARTMessageType::FingerprintError,
@@ -61,108 +876,48 @@ void FPM383CTask() {
 			};
 			osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&msg), 0, 50);
 
-			osDelay(200);
+			if (RecoverLink(fpm383c) == FPM383C::RecoveryLevel::Failed) {
+				osDelay(RecoveryRetryDelayMs);
+			} else {
+				osDelay(200);
+			}
 			continue;
 		} else if (!isPressed) {
-			// 手指未按下，继续等待
-
-			auto [ledControlStatus, ledControlErrorCode] = fpm383c.SetLEDControl(FPM383C::LEDControl::ControlInfo(
-				FPM383C::LEDControl::Mode::Off
-			));
-			UARTMessage ledMsg{
-				.type = UARTMessageType::LEDControl,
-				.data1 = static_cast<uint8_t>(ledControlStatus),
-				.data2 = static_cast<uint16_t>(ledControlErrorCode)
-			};
-			osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&ledMsg), 0, 50);
-
-			auto [enterSleepModeStatus, enterSleepModeErrorCode] = fpm383c.EnterSleepMode();
-			UARTMessage sleepMsg{
-				.type = UARTMessageType::FingerprintEnterSleepMode,
-				.data1 = static_cast<uint8_t>(enterSleepModeStatus),
-				.data2 = static_cast<uint16_t>(enterSleepModeErrorCode)
-			};
-			osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&sleepMsg), 0, 50);
+			// 手指未按下，关灯并休眠后继续等待
+			latencyTrace.EndAttempt();
+			EnterStandby(fpm383c);
 
 			osDelay(100);
 			continue;
 		}
 
-		// 手指已按下，执行匹配
-		UARTMessage startMsg{
-			.type = UARTMessageType::FingerprintMatchStart
-		};
-		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&startMsg), 0, 50);
+		// 手指已按下，执行匹配 (身份已知时为 1:1 比对)
+		const uint16_t hintedId = insideSensor.TakeIdentityHint(osKernelGetTickCount());
+		SendMatchStartMessage(hintedId);
+		attemptRate.Record(osKernelGetTickCount());
 
 		FPM383C::MatchResult matchResult;
-		auto [matchStatus, matchErrCode] = fpm383c.Match(matchResult);
-		if (matchStatus != FPM383C::Status::OK) {
-			// 匹配过程中出现错误，发送错误消息
-			UARTMessage msg{
-				.type = UARTMessageType::FingerprintError,
-				.errorCode = static_cast<uint8_t>(matchStatus),
-				.moduleErrorCode = static_cast<uint16_t>(matchErrCode)
-			};
-			osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&msg), 0, 50);
-
+		if (!MatchAndPostToServo(fpm383c, matchResult, hintedId)) {
+			RecoverLink(fpm383c);
 			osDelay(250);
 			continue;
 		}
 
-		ServoMessage openDoorMsg{
-			.type = matchResult.IsSuccess ? ServoMessageType::MoveToUnlockPosition : ServoMessageType::MoveToResetPosition
-		};
-		osMessageQueuePut(ServoQueueHandle, reinterpret_cast<uint32_t *>(&openDoorMsg), 0, 100); // Servo 队列多等待一些时间
+		ReportMatch(fpm383c, matchResult, &fingerprintIndex);
 
-		UARTMessage msg{
-			.type = UARTMessageType::FingerprintMatchComplete,
-			.fingerprintMatchResult = matchResult.IsSuccess,
-			.fingerprintId = matchResult.FingerId
-		};
-		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&msg), 0, 50);
-
-		if (matchResult.IsSuccess) {
-			// 匹配成功，自学习
-			auto [updateStatus, updateErrCode] = fpm383c.UpdateFeatureAfterMatch(matchResult.FingerId);
-			if (updateStatus == FPM383C::Status::OK || updateErrCode == FPM383C::ModuleErrorCode::FeatureNotNeedUpdate) {
-				// 自学习成功，发送成功消息
-				UARTMessage updateSuccessMsg{
-					.type = UARTMessageType::FingerprintUpdateFeatureAfterMatch,
-					.data1 = static_cast<uint8_t>(updateStatus),
-					.data2 = static_cast<uint16_t>(updateErrCode)
-				};
-				osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&updateSuccessMsg), 0, 50);
-			} else {
-				// 自学习过程中出现错误，发送错误消息
-				UARTMessage updateMsg{
-					.type = UARTMessageType::FingerprintError,
-					.errorCode = static_cast<uint8_t>(updateStatus),
-					.moduleErrorCode = static_cast<uint16_t>(updateErrCode)
-				};
-				osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&updateMsg), 0, 50);
-			}
+		if constexpr (UseThroughputMode) {
+			// 不等待关灯和休眠，手指离开后即可开始下一次识别
+			ReportThroughput(attemptRate);
+			isAwaitingLift = true;
+			throughputDeadline = osKernelGetTickCount() + LiftTimeoutMs;
+			continue;
 		}
 
-		osDelay(400);  // 400ms 后关灯
-
-		auto [ledControlStatus, ledControlErrorCode] = fpm383c.SetLEDControl(FPM383C::LEDControl::ControlInfo(
-			FPM383C::LEDControl::Mode::Off
-		));
-		UARTMessage ledMsg{
-			.type = UARTMessageType::LEDControl,
-			.data1 = static_cast<uint8_t>(ledControlStatus),
-			.data2 = static_cast<uint16_t>(ledControlErrorCode)
-		};
-		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&ledMsg), 0, 50);
+		osDelay(StandbyDelayMs);  // 400ms 后关灯
 
-		auto [enterSleepModeStatus, enterSleepModeErrorCode] = fpm383c.EnterSleepMode();
-		UARTMessage sleepMsg{
-			.type = UARTMessageType::FingerprintEnterSleepMode,
-			.data1 = static_cast<uint8_t>(enterSleepModeStatus),
-			.data2 = static_cast<uint16_t>(enterSleepModeErrorCode)
-		};
-		osMessageQueuePut(UARTQueueHandle, reinterpret_cast<uint32_t *>(&sleepMsg), 0, 50);
+		RunDeferredFeatureUpdate(fpm383c);
+		EnterStandby(fpm383c);
 
-		osDelay(600); // 识别后延迟久一点
+		osDelay(SettleDelayMs); // 识别后延迟久一点
 	}
 }
\ No newline at end of file
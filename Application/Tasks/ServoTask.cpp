@@ -1,4 +1,5 @@
 #include "cmsis_os.h"
+#include "LatencyTrace_Shared.h"
 #include "Servo_Shared.h"
 #include "usart.h"
 
@@ -45,6 +46,8 @@ void ServoTask() {
 			case ServoMessageType::MoveToUnlockPosition:
 				// 立即移动到解锁位置
 				servo.SetAngle(ServoUnlockAngle);
+				latencyTrace.Mark(LatencyTrace::Phase::ServoSetAngle);
+				latencyTrace.EndAttempt();
 				SendUARTMessage(UARTMessageType::ServoMovingToUnlockPosition);
 				currentState = ServoState::MovingToUnlock;
 				stateStartTick = osKernelGetTickCount();
@@ -53,6 +56,8 @@ void ServoTask() {
 			case ServoMessageType::MoveToResetPosition:
 				// 立即移动到复位位置，放弃当前状态
 				servo.SetAngle(ServoResetAngle);
+				latencyTrace.Mark(LatencyTrace::Phase::ServoSetAngle);
+				latencyTrace.EndAttempt();
 				SendUARTMessage(UARTMessageType::ServoMovingToResetPosition);
 				currentState = ServoState::MovingToReset;
 				stateStartTick = osKernelGetTickCount();
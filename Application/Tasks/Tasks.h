@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// 任务入口，由 freertos.cpp 中 CubeMX 生成的线程函数调用
+void LEDTask();
+void UARTTask();
+void FPM383CTask();
+void ServoTask();
+
+// 给出门内侧指纹传感器下一次触摸的已知身份 (密码、卡片或远程请求)，可在任意任务或 ISR 中调用
+void HintFingerprintIdentity(uint16_t fingerId);
+
+// 在门内侧指纹传感器上注册指纹并记录所属用户，进度和结果经 UART 上报；在任务中调用，返回注册是否已开始
+bool RequestFingerprintEnroll(uint16_t userId);
+
+// 删除门内侧指纹传感器上的指纹并更新本地索引，结果经 UART 上报；在任务中调用，返回删除是否已开始
+bool RequestFingerprintDelete(uint16_t fingerId);
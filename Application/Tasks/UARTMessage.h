@@ -21,6 +21,14 @@ enum class UARTMessageType : uint8_t {
 	ServoMovingToResetPosition,
 	ServoRelease,
 	LEDControl,
+	FingerprintStandby,
+	FingerprintInit,
+	FingerprintMatchUser,
+	FingerprintIndexReconcile,
+	FingerprintRecovery,
+	FingerprintVerifyStart,
+	FingerprintThroughput,
+	FingerprintDelete,
 };
 
 // 8bit + 8bit + 16bit
@@ -70,6 +78,22 @@ inline constexpr std::string_view to_string(UARTMessageType type) {
 		return "ServoRelease";
 	case UARTMessageType::LEDControl:
 		return "LEDControl";
+	case UARTMessageType::FingerprintStandby:
+		return "FingerprintStandby";
+	case UARTMessageType::FingerprintInit:
+		return "FingerprintInit";
+	case UARTMessageType::FingerprintMatchUser:
+		return "FingerprintMatchUser";
+	case UARTMessageType::FingerprintIndexReconcile:
+		return "FingerprintIndexReconcile";
+	case UARTMessageType::FingerprintRecovery:
+		return "FingerprintRecovery";
+	case UARTMessageType::FingerprintVerifyStart:
+		return "FingerprintVerifyStart";
+	case UARTMessageType::FingerprintThroughput:
+		return "FingerprintThroughput";
+	case UARTMessageType::FingerprintDelete:
+		return "FingerprintDelete";
 	default:
 		return "Unknown";
 	}
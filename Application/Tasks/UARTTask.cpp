@@ -2,13 +2,18 @@
 #include "usart.h"
 
 #include <array>
+#include <charconv>
 #include <cstring>
 
+#include "FPM383C_Shared.h"
+#include "LatencyTrace_Shared.h"
+#include "Tasks.h"
 #include "UARTMessage.h"
 #include "strings.h"
 
 bool uart1TxComplete = true;
 bool uart1RxComplete = false;
+uint16_t uart1RxSize = 0;
 
 // static std::array<uint8_t, 128> uart1TxBuffer{};
 std::array<uint8_t, 128> uart1TxBuffer{};
@@ -18,11 +23,128 @@ void StartReceiveDMA() {
 	HAL_UARTEx_ReceiveToIdle_DMA(&huart1, uart1RxBuffer.data(), uart1RxBuffer.size());
 }
 
+// 通过 DMA 发送 uart1TxBuffer 中的一行并等待发送完成
+static void SendLineAndWait(size_t length) {
+	while (!uart1TxComplete) {
+		osDelay(1);
+	}
+	uart1TxComplete = false;
+	HAL_UART_Transmit_DMA(&huart1, uart1TxBuffer.data(), length);
+	while (!uart1TxComplete) {
+		osDelay(1);
+	}
+}
+
+// 将指纹模块接收中断和完成分发的耗时统计 (CPU 周期) 格式化为一行文本
+static size_t FormatIsrStats(const FPM383C::IsrStats &stats, std::span<char> output) {
+	constexpr std::string_view isrLabel = "isr max=";
+	constexpr std::string_view lastLabel = " last=";
+	constexpr std::string_view dispatchLabel = " dispatch=";
+	constexpr std::string_view countLabel = " n=";
+	constexpr std::string_view droppedLabel = " dropped=";
+	char *buffer = std::copy(isrLabel.begin(), isrLabel.end(), output.data());
+	buffer += uint32ToString(stats.MaxRxIsrCycles, buffer);
+	buffer = std::copy(lastLabel.begin(), lastLabel.end(), buffer);
+	buffer += uint32ToString(stats.LastRxIsrCycles, buffer);
+	buffer = std::copy(dispatchLabel.begin(), dispatchLabel.end(), buffer);
+	buffer += uint32ToString(stats.MaxDispatchCycles, buffer);
+	buffer = std::copy(countLabel.begin(), countLabel.end(), buffer);
+	buffer += uint32ToString(stats.DispatchedCompletions, buffer);
+	buffer = std::copy(droppedLabel.begin(), droppedLabel.end(), buffer);
+	buffer += uint32ToString(stats.DroppedCompletions, buffer);
+	*buffer++ = '\n';
+	*buffer = '\0';
+	return buffer - output.data();
+}
+
+// 解析完整的十进制 uint16_t 参数
+static bool ParseUint16(std::string_view text, uint16_t &value) {
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc() && end == text.data() + text.size();
+}
+
+// 发送一行固定文本
+static void SendTextAndWait(std::string_view text) {
+	const auto end = std::copy(text.begin(), text.end(), uart1TxBuffer.begin());
+	SendLineAndWait(end - uart1TxBuffer.begin());
+}
+
+// 处理 UART1 收到的调试命令，返回 true 表示已处理
+static bool HandleCommand(std::string_view command) {
+	// 去掉结尾的换行
+	while (!command.empty() && (command.back() == '\n' || command.back() == '\r')) {
+		command.remove_suffix(1);
+	}
+
+	auto buffer = std::span(reinterpret_cast<char *>(uart1TxBuffer.data()), uart1TxBuffer.size());
+	if (command == "trace") {
+		// 输出所有开门延迟记录 (微秒，相对触摸)
+		for (size_t i = 0; i < latencyTrace.GetRecordCount(); i++) {
+			SendLineAndWait(latencyTrace.FormatRecord(i, buffer));
+		}
+		return true;
+	}
+	if (command == "stats") {
+		// 输出各阶段的 min/avg/p99 (微秒，相对触摸)
+		for (size_t i = 0; i < LatencyTrace::PHASE_COUNT; i++) {
+			SendLineAndWait(latencyTrace.FormatSummary(static_cast<LatencyTrace::Phase>(i), buffer));
+		}
+		return true;
+	}
+	constexpr std::string_view verifyPrefix = "verify ";
+	if (command.starts_with(verifyPrefix)) {
+		// 模拟已知身份的开门请求: 下一次触摸以 1:1 比对代替 1:N 匹配
+		uint16_t fingerId = 0;
+		if (!ParseUint16(command.substr(verifyPrefix.size()), fingerId)) {
+			return false;
+		}
+		HintFingerprintIdentity(fingerId);
+		return true;
+	}
+	constexpr std::string_view enrollPrefix = "enroll ";
+	if (command.starts_with(enrollPrefix)) {
+		// 为指定用户注册指纹，ID 由本地索引分配，进度和结果经消息队列上报
+		uint16_t userId = 0;
+		if (!ParseUint16(command.substr(enrollPrefix.size()), userId)) {
+			return false;
+		}
+		if (!RequestFingerprintEnroll(userId)) {
+			SendTextAndWait("busy\n");
+		}
+		return true;
+	}
+	constexpr std::string_view deletePrefix = "delete ";
+	if (command.starts_with(deletePrefix)) {
+		// 删除指定 ID 的指纹并更新本地索引，结果经消息队列上报
+		uint16_t fingerId = 0;
+		if (!ParseUint16(command.substr(deletePrefix.size()), fingerId)) {
+			return false;
+		}
+		if (!RequestFingerprintDelete(fingerId)) {
+			SendTextAndWait("busy\n");
+		}
+		return true;
+	}
+	if (command == "isr") {
+		// 输出接收中断的最坏耗时和移到任务中的回调耗时 (CPU 周期)，两者之和即回调在中断中执行时的最坏耗时
+		SendLineAndWait(FormatIsrStats(fpm383c.GetIsrStats(), buffer));
+		return true;
+	}
+	return false;
+}
+
 void UARTTask() {
 	while (true) {
 		if (uart1RxComplete) {
 			uart1RxComplete = false;
-			HAL_UART_Transmit_DMA(&huart1, reinterpret_cast<const uint8_t *>("UART RX Complete\n"), 18);
+			const std::string_view command(reinterpret_cast<const char *>(uart1RxBuffer.data()), uart1RxSize);
+			if (!HandleCommand(command)) {
+				while (!uart1TxComplete) {
+					osDelay(1);
+				}
+				uart1TxComplete = false;
+				HAL_UART_Transmit_DMA(&huart1, reinterpret_cast<const uint8_t *>("UART RX Complete\n"), 18);
+			}
 			StartReceiveDMA();
 			osDelay(50);
 		}
@@ -25,7 +25,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "Tasks.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -189,7 +189,6 @@ void MX_FREERTOS_Init(void) {
 }
 
 /* USER CODE BEGIN Header_StartLEDTask */
-void LEDTask(void);
 /**
   * @brief  Function implementing the LEDTask thread.
   * @param  argument: Not used
@@ -204,7 +203,6 @@ void StartLEDTask(void *argument) {
 }
 
 /* USER CODE BEGIN Header_StartUARTTask */
-void UARTTask(void);
 /**
 * @brief Function implementing the UARTTask thread.
 * @param argument: Not used
@@ -219,7 +217,6 @@ void StartUARTTask(void *argument) {
 }
 
 /* USER CODE BEGIN Header_StartFPM383CTask */
-void FPM383CTask(void);
 /**
 * @brief Function implementing the FPM383CTask thread.
 * @param argument: Not used
@@ -234,7 +231,6 @@ void StartFPM383CTask(void *argument) {
 }
 
 /* USER CODE BEGIN Header_StartServoTask */
-void ServoTask(void);
 /**
 * @brief Function implementing the ServoTask thread.
 * @param argument: Not used
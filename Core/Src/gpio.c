@@ -61,10 +61,14 @@ void MX_GPIO_Init(void)
 
   /*Configure GPIO pin : FingerprintModuleTouchSensor_Pin */
   GPIO_InitStruct.Pin = FingerprintModuleTouchSensor_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(FingerprintModuleTouchSensor_GPIO_Port, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI2_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(EXTI2_IRQn);
+
 }
 
 /* USER CODE BEGIN 2 */
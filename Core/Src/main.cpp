@@ -9,7 +9,9 @@ void SystemClock_Config(void);
 void MX_FREERTOS_Init(void);
 
 #include "Button_Shared.h"
+#include "FlashConfig_Shared.h"
 #include "FPM383C_Shared.h"
+#include "LatencyTrace_Shared.h"
 
 void StartReceiveDMA(); // 启动 UART1 的 DMA 接收
 
@@ -32,6 +34,12 @@ int main(void) {
 	// 启动 UART2 空闲中断
 	__HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
 
+	// 读取 Flash 中保存的配置 (如指纹模块波特率)
+	flashConfig.Init();
+
+	// 启用 DWT 周期计数器，用于开门延迟记录
+	latencyTrace.Init();
+
 	osKernelInitialize();  /* Call init function for freertos objects (in cmsis_os2.c) */
 	MX_FREERTOS_Init();
 
@@ -0,0 +1,24 @@
+# 读取 FPM383C.cpp 导出的绝对符号，报告当前命令集下收发缓冲区占用和节省的 RAM
+# 用法: cmake -DNM=<nm> -DELF=<elf> -DCOMMAND_SET=<name> -P fpm383c-ram-report.cmake
+
+execute_process(
+    COMMAND ${NM} ${ELF}
+    OUTPUT_VARIABLE NM_OUTPUT
+    RESULT_VARIABLE NM_RESULT
+)
+if(NOT NM_RESULT EQUAL 0)
+    message(WARNING "FPM383C RAM report: failed to run ${NM} on ${ELF}")
+    return()
+endif()
+
+foreach(NAME rx_buffer_bytes tx_buffer_bytes buffer_saving_bytes)
+    if(NM_OUTPUT MATCHES "([0-9a-fA-F]+) [Aa] fpm383c_${NAME}")
+        math(EXPR ${NAME} "0x${CMAKE_MATCH_1}")
+    else()
+        message(WARNING "FPM383C RAM report: symbol fpm383c_${NAME} not found")
+        return()
+    endif()
+endforeach()
+
+math(EXPR total_bytes "${rx_buffer_bytes} + ${tx_buffer_bytes}")
+message(STATUS "FPM383C command set ${COMMAND_SET}: RX ${rx_buffer_bytes} B + TX ${tx_buffer_bytes} B = ${total_bytes} B, saves ${buffer_saving_bytes} B RAM versus the fixed 256-byte RX + 256-byte TX buffers (512 B)")